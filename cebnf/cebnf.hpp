@@ -3,9 +3,13 @@
 
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <array>
 #include <memory>
+#include <new>
 #include <type_traits>
+#include <cstdint>
+#include <cstring>
 #include <assert.h>
 
 /*C++ Extended Backus-Naur Form (beta version)
@@ -17,6 +21,23 @@ optional: [ ebnf ] -> t[ ebnf ] with CEBNF_OperatorTools t;
 repetition: { ebnf } -> t( ebnf ) with CEBNF_OperatorTools t;
 or  { ebnf } -> t({ ebnf }) with CEBNF_OperatorTools t;
 
+Extension:
+lexeme: t.lexeme( ebnf ) matches ebnf and creates only one token (no inner nodes).
+drop: t.drop( ebnf ) matches ebnf and creates no node (for punctuation).
+compile-time term: Lit<"text">() (C++20) or Literal<'t', 'e', 'x', 't'>() = Term("text").
+skipper: f.setSkipper( ebnf ) skips ebnf around the input and between the elements of concatenation and repetition.
+pratt: t.pratt( operand, { { "+", 10 }, { "*", 20 } } ) binary operators by precedence (one node per operator).
+lazy: f.setLazy() or f.setLazy( ebnf ) creates the node of f without children, they are parsed on the first node->expand() / getChildren().
+parser generator: CodeGenerator(rule, options).generate(code) emits a recursive descent parser of the grammar (cebnf_codegen.hpp, expressions describe() themselves as GrammarExpr).
+tree shape: f.setShape( shape_collapse ) replaces the node of f by its only child, f.setShape( shape_omit ) promotes the children of f to the parent.
+shared subtrees: SyntaxDag::add(tree) interns identical subtrees into one DagNode, DagCache keeps one result per DagNode (cebnf_dag.hpp).
+segmented input: f.parse(InputSegments().add(p1, n1).add(p2, n2)) parses the pieces of a rope / piece table without joining them.
+error report: f.parse(s, error) records the farthest failure and the terminals expected there, errorMessage(error, LineIndex(s)) gives line:column (cebnf_diagnostic.hpp).
+search: Searcher(f).findAll(text) returns every non-overlapping match of f in text, skipping positions outside the FIRST set of f (cebnf_search.hpp).
+parallel search: ParallelScanner(searcher).run(paths) searches many files (large ones in chunks at newlines) on every core, scanMain(argc, argv, f) is its command line tool (cebnf_parallel.hpp).
+ebnf text: EbnfGrammar::load(text, options) builds the rules of ISO EBNF text at run time (Rule: token id given at run time), names not defined in the text are bound C++ expressions (cebnf_ebnf.hpp).
+grammar image: GrammarImage().encode(f, bytes) stores the prepared analysis of a grammar (rules, optimized definitions, FIRST, nullable), GrammarImage::load(bytes, options) rebuilds the rules without the analysis, toCpp embeds the image (cebnf_image.hpp).
+
 <---note--->
 Cebnf does not implemnet exception symbol.
 
@@ -35,67 +56,641 @@ t({ +f })
 */
 namespace cebnf {
 
+	enum cebnf_type {
+		base_begin = 10000000,
+		terminus,
+		epsilon,
+		lexeme,
+		binary,//Pratt: operator node of children lhs, rhs
+		operand,//Pratt: operand of several nodes
+		base_end
+	};
+
+	/*match_impl result when the expression does not match*/
+	constexpr std::size_t no_match = static_cast<std::size_t>(-1);
+
+	/*syntax tree shape of a rule (CEBNF::setShape)
+	- shape_keep: the node of the rule with its children
+	- shape_collapse: the node of the rule is replaced by its child when it has exactly one (unit productions A -> B -> token)
+	- shape_omit: no node of the rule, its children are promoted to the parent node*/
+	enum tree_shape { shape_keep, shape_collapse, shape_omit };
+
+	/*vector of movable elements with the first N stored in the object, then in a heap array that grows geometrically.
+	a short list needs no heap block and is read without an extra pointer hop. only [0, size()) is constructed,
+	so an empty or moved-from list costs nothing to move or destroy.*/
+	template<class T, std::size_t N>
+	class SmallVector {
+	public:
+		using value_type = T;
+		using iterator = T*;
+		using const_iterator = const T*;
+
+		SmallVector() {}
+		SmallVector(SmallVector&& m) noexcept { take(m); }
+		SmallVector& operator=(SmallVector&& m) noexcept {
+			if (this != &m) {
+				clear();
+				release();
+				take(m);
+			}
+			return *this;
+		}
+		SmallVector(SmallVector const&) = delete;
+		SmallVector& operator=(SmallVector const&) = delete;
+		~SmallVector() {
+			clear();
+			release();
+		}
+
+		std::size_t size() const { return _size; }
+		bool empty() const { return _size == 0; }
+		std::size_t capacity() const { return _capacity; }
+		/*elements are stored in the object (no heap array)*/
+		bool isInline() const { return _data == inlineData(); }
+
+		T* data() { return _data; }
+		const T* data() const { return _data; }
+		iterator begin() { return _data; }
+		iterator end() { return _data + _size; }
+		const_iterator begin() const { return _data; }
+		const_iterator end() const { return _data + _size; }
+
+		T& operator[](std::size_t i) { return _data[i]; }
+		const T& operator[](std::size_t i) const { return _data[i]; }
+		T& front() { return _data[0]; }
+		const T& front() const { return _data[0]; }
+		T& back() { return _data[_size - 1]; }
+		const T& back() const { return _data[_size - 1]; }
+
+		void reserve(std::size_t n) {
+			if (n <= _capacity) return;
+
+			T* data = static_cast<T*>(::operator new(n * sizeof(T)));
+			const std::uint32_t size = _size;
+			moveTo(data);
+			release();
+			_data = data;
+			_size = size;
+			_capacity = static_cast<std::uint32_t>(n);
+		}
+
+		void push_back(T&& v) { emplace_back(std::move(v)); }
+
+		template<class... Args>
+		T& emplace_back(Args&&... args) {
+			if (_size == _capacity) {
+				T v(std::forward<Args>(args)...); /*args may refer to an element*/
+				reserve(_capacity * 2);
+				return *new (_data + _size++) T(std::move(v));
+			}
+			return *new (_data + _size++) T(std::forward<Args>(args)...);
+		}
+
+		void pop_back() { _data[--_size].~T(); }
+
+		/*the heap array is kept (same as std::vector)*/
+		void clear() {
+			for (std::size_t i = 0; i < _size; ++i) _data[i].~T();
+			_size = 0;
+		}
+
+		/*move src to the end. an empty list takes the src storage, otherwise the capacity grows geometrically
+		(an exact reserve per append reallocates on every element of a long list)*/
+		void append(SmallVector&& src) {
+			if (empty()) {
+				*this = std::move(src);
+				return;
+			}
+
+			const std::size_t size = _size + src._size;
+			if (size > _capacity) reserve(std::max<std::size_t>(size, _capacity * 2));
+			src.moveTo(_data + _size);
+			_size = static_cast<std::uint32_t>(size);
+		}
+
+	private:
+		T* inlineData() { return reinterpret_cast<T*>(_inline); }
+		const T* inlineData() const { return reinterpret_cast<const T*>(_inline); }
+
+		/*move the elements to the uninitialized dst, this becomes empty (the storage is kept)*/
+		void moveTo(T* dst) {
+			for (std::size_t i = 0; i < _size; ++i) {
+				new (dst + i) T(std::move(_data[i]));
+				_data[i].~T();
+			}
+			_size = 0;
+		}
+
+		/*free the heap array (no element is left)*/
+		void release() {
+			if (!isInline()) ::operator delete(_data);
+			_data = inlineData();
+			_capacity = N;
+		}
+
+		/*this is empty and inline. m is inline: move its elements, else take its heap array*/
+		void take(SmallVector& m) {
+			if (m.isInline()) {
+				_size = m._size;
+				m.moveTo(_data);
+				return;
+			}
+			_data = m._data;
+			_size = m._size;
+			_capacity = m._capacity;
+			m._data = m.inlineData();
+			m._size = 0;
+			m._capacity = N;
+		}
+
+		alignas(T) unsigned char _inline[N * sizeof(T)];
+		T* _data = inlineData();
+		std::uint32_t _size = 0;
+		std::uint32_t _capacity = N;
+	};
+
+	class SyntaxNode;
+
+	/*children of a node and nodes of a parse result (most nodes have 1 to 3 children)*/
+	using SyntaxNodeList = SmallVector<std::unique_ptr<SyntaxNode>, 3>;
+
+	struct CEBNFBase;
+
 	class SyntaxNode {
 		friend class SyntaxNode;
 	public:
-		SyntaxNode(std::size_t token_id, std::string s) : _token_id(token_id), _s(s) {}
+		SyntaxNode(std::size_t token_id, std::string s) : _token_id(token_id), _s(std::move(s)) {}
+		SyntaxNode(std::size_t token_id, std::string s, std::size_t begin, std::size_t length) : _token_id(token_id), _s(std::move(s)), _begin(begin), _length(length) {}
 		//SyntaxNode(SyntaxNode const& m) : _token_id(m._token_id), _s(m._s), children(m.children) {}
-		SyntaxNode(SyntaxNode&& m) noexcept : _token_id(m._token_id), _s(m._s), children(std::move(m.children)) {
+		SyntaxNode(SyntaxNode&& m) noexcept : children(std::move(m.children)), _token_id(m._token_id), _s(std::move(m._s)), _begin(m._begin), _length(m._length), _value_type(m._value_type), _value(m._value), _lazy(std::move(m._lazy)) {
 		}
 
-		std::vector<std::unique_ptr<SyntaxNode>> children;
+		SyntaxNodeList children;
+
+		std::size_t getTokenID() const { return _token_id; }
+		const std::string& getString() const { return _s; }
+
+		/*source span [begin, begin + length) in the parsed string*/
+		std::size_t getBegin() const { return _begin; }
+		std::size_t getLength() const { return _length; }
+
+		/*parsed value of numeric tokens (Integer, RealNumber, Number)
+		- isInteger: the token is an integer that fits int64 (getInteger), isReal: any other number (getReal)*/
+		bool hasValue() const { return _value_type != value_none; }
+		bool isInteger() const { return _value_type == value_integer; }
+		bool isReal() const { return _value_type == value_real; }
+		std::int64_t getInteger() const { return _value_type == value_integer ? _value.integer : 0; }
+		double getReal() const { return _value_type == value_integer ? static_cast<double>(_value.integer) : _value.real; }
+
+		void setInteger(std::int64_t v) { _value_type = value_integer; _value.integer = v; }
+		void setReal(double v) { _value_type = value_real; _value.real = v; }
+
+		/*node of a lazy rule (CEBNF::setLazy): children are parsed from the node string on the first expand() / getChildren(),
+		then cached in place. expand() is false if the content does not parse (children stay empty).
+		the grammar must outlive the node. not thread-safe.*/
+		bool isLazy() const { return _lazy != nullptr && !_lazy->failed; }
+		bool expand();
+		SyntaxNodeList& getChildren() {
+			expand();
+			return children;
+		}
+
+		/*rule: the definition parsed by expand(), skipper: the skipper of the parse*/
+		void setLazy(const CEBNFBase* rule, const CEBNFBase* skipper) {
+			_lazy.reset(new Lazy{ rule, skipper, false });
+		}
 
-		std::size_t getTokenID() { return _token_id; }
-		std::string getString() { return _s; }
+		void mergeChildren(SyntaxNodeList&& new_children) {
+			children.append(std::move(new_children));
+		}
 
-		void mergeChildren(std::vector<std::unique_ptr<SyntaxNode>>&& new_children) {
-			children.reserve(children.size() + new_children.size());
-			std::move(new_children.begin(), new_children.end(), std::back_inserter(children));
+		/*move src to the end of dst (SmallVector::append)*/
+		static void append(SyntaxNodeList& dst, SyntaxNodeList&& src) {
+			dst.append(std::move(src));
 		}
 
 	private:
 		std::size_t _token_id;
 		std::string _s;
+		std::size_t _begin = 0;
+		std::size_t _length = 0;
+
+		enum : unsigned char { value_none, value_integer, value_real } _value_type = value_none;
+		union {
+			std::int64_t integer;
+			double real;
+		} _value = {};
+
+		struct Lazy {
+			const CEBNFBase* rule;
+			const CEBNFBase* skipper;
+			bool failed;
+		};
+		std::unique_ptr<Lazy> _lazy;
+	};
+
+	using SyntaxTree = std::pair<SyntaxNodeList, std::size_t>;
+
+	struct CEBNFBase;
+
+	/*farthest failure of a parse (CEBNF::parse(s, error)): the parse stopped at position, expecting one of the terminals.
+	tracked during the parse itself (a compare per failed terminal). line and column: LineIndex (cebnf_diagnostic.hpp).*/
+	struct ParseError {
+		std::size_t position = 0;
+		std::vector<const CEBNFBase*> expected; /*terminals tried at position, nullptr: end of input*/
+
+		void add(std::size_t pos, const CEBNFBase* e) {
+			if (pos < position) {
+				return;
+			}
+			if (pos > position) {
+				position = pos;
+				expected.clear();
+			}
+			if (std::find(expected.begin(), expected.end(), e) == expected.end()) {
+				expected.push_back(e);
+			}
+		}
+	};
+
+	/*non-contiguous input: the pieces of a rope / piece table in order (CEBNF::parse(segments)).
+	the bytes are not copied, they must live until the parse ends. positions are offsets in the whole input.*/
+	class InputSegments {
+	public:
+		struct Piece {
+			const char* p;
+			std::size_t n;
+			std::size_t begin; /*offset of p[0] in the input*/
+		};
+
+		InputSegments() {}
+		InputSegments(const char* p, std::size_t n) { add(p, n); }
+		explicit InputSegments(const std::string& s) { add(s); }
+
+		/*append a piece (empty pieces are ignored)*/
+		InputSegments& add(const char* p, std::size_t n) {
+			if (n != 0) {
+				_pieces.push_back(Piece{ p, n, _size });
+				_size += n;
+			}
+			return *this;
+		}
+		InputSegments& add(const std::string& s) { return add(s.data(), s.size()); }
+
+		std::size_t size() const { return _size; }
+		const std::vector<Piece>& pieces() const { return _pieces; }
+
+		/*one std::string (copy)*/
+		std::string str() const {
+			std::string res;
+			res.reserve(_size);
+			for (const auto& piece : _pieces) res.append(piece.p, piece.n);
+			return res;
+		}
+
+		/*index of the piece of pos (pos < size()). hint: the piece of the previous lookup*/
+		std::size_t find(std::size_t pos, std::size_t hint) const {
+			if (hint < _pieces.size() && pos >= _pieces[hint].begin) {
+				if (pos - _pieces[hint].begin < _pieces[hint].n) return hint;
+				if (hint + 1 < _pieces.size() && pos - _pieces[hint + 1].begin < _pieces[hint + 1].n) return hint + 1;
+			}
+			const auto itr = std::upper_bound(_pieces.begin(), _pieces.end(), pos, [](std::size_t v, const Piece& piece) { return v < piece.begin; });
+			return static_cast<std::size_t>(itr - _pieces.begin()) - 1;
+		}
+
+	private:
+		std::vector<Piece> _pieces;
+		std::size_t _size = 0;
 	};
 
-	using SyntaxTree = std::pair<std::vector<std::unique_ptr<SyntaxNode>>, std::size_t>;
+	/*parse input: the string and the settings shared by every expression in one parse.
+	contiguous (std::string, one piece): s[i] and data() read the bytes in place.
+	segments (several pieces): s[i] finds the piece (the last one is cached, sequential reads are O(1)), data() is nullptr.
+	expressions that scan with pointers use scan(), which gives them contiguous windows of the input.*/
+	class Input {
+	public:
+		Input(const std::string& s, const CEBNFBase* skipper = nullptr, ParseError* error = nullptr) : _p(s.data()), _n(s.size()), _size(s.size()), _skipper(skipper), _error(error) {}
+		Input(const InputSegments& segs, const CEBNFBase* skipper = nullptr, ParseError* error = nullptr) : _size(segs.size()), _skipper(skipper), _error(error) {
+			if (segs.pieces().size() == 1) {
+				/*fast path: one piece is contiguous*/
+				_p = segs.pieces()[0].p;
+				_n = _size;
+			}
+			else if (segs.pieces().size() > 1) {
+				_segs = &segs;
+			}
+		}
+
+		const CEBNFBase* skipper() const { return _skipper; }
+
+		bool contiguous() const { return _segs == nullptr; }
+		/*contiguous() only (segments: nullptr)*/
+		const char* data() const { return _segs == nullptr ? _p : nullptr; }
+		std::size_t size() const { return _size; }
+		std::size_t length() const { return _size; }
+
+		std::string substr(std::size_t pos, std::size_t n = std::string::npos) const {
+			if (pos > _size) pos = _size;
+			if (n > _size - pos) n = _size - pos;
+			if (_segs == nullptr) {
+				return std::string(_p + pos, n);
+			}
+			std::string res;
+			res.reserve(n);
+			copy(pos, n, res);
+			return res;
+		}
+
+		/*s[i] for i >= size() is '\0'*/
+		char operator[](std::size_t i) const {
+			/*_n is 0 for segments*/
+			return i < _n ? _p[i] : at(i);
+		}
+
+		/*s[pos, pos + n) == t[0, n)*/
+		bool equal(std::size_t pos, const char* t, std::size_t n) const {
+			if (pos > _size || _size - pos < n) {
+				return false;
+			}
+			if (_segs == nullptr) {
+				return std::equal(t, t + n, _p + pos);
+			}
+			for (std::size_t i = 0; i < n; ++i) {
+				if (at(pos + i) != t[i]) return false;
+			}
+			return true;
+		}
+
+		/*f(p, n): scan of a token at p = &s[begin] with n bytes to the end of the input or of the window, returns its length or no_match.
+		contiguous: one call. segments: the window is the rest of the piece (in place), then a copy twice as long
+		until f matches inside the window (length < n) or the window reaches the end of the input.
+		no_match is tried again on the longer windows: check the first byte before scan().*/
+		template<class F>
+		std::size_t scan(std::size_t begin, F&& f) const {
+			if (begin > _size) {
+				return no_match;
+			}
+			if (_segs == nullptr) {
+				return f(_p + begin, _size - begin);
+			}
+			if (begin == _size) {
+				return f("", 0);
+			}
+
+			_piece = _segs->find(begin, _piece);
+			const InputSegments::Piece& piece = _segs->pieces()[_piece];
+			const char* p = piece.p + (begin - piece.begin);
+			std::size_t n = piece.n - (begin - piece.begin);
+			std::string window;
+			while (true) {
+				const std::size_t len = f(p, n);
+				if ((len != no_match && len < n) || n == _size - begin) {
+					return len;
+				}
+				n = std::min(std::max<std::size_t>(n * 2, 64), _size - begin);
+				window.clear();
+				copy(begin, n, window);
+				p = window.data();
+			}
+		}
+
+		/*first position from pos that the skipper does not match*/
+		std::size_t skip(std::size_t pos) const;
+
+		/*same input without the skipper (lexeme)*/
+		Input noSkip() const {
+			Input res(*this);
+			res._skipper = nullptr;
+			return res;
+		}
+
+		/*diagnostics: terminal e does not match at pos (nullptr: the end of the input was expected)*/
+		void fail(std::size_t pos, const CEBNFBase* e) const {
+			if (_error != nullptr) _error->add(pos, e);
+		}
+
+	private:
+		char at(std::size_t i) const {
+			if (_segs == nullptr || i >= _size) {
+				return '\0';
+			}
+			_piece = _segs->find(i, _piece);
+			const InputSegments::Piece& piece = _segs->pieces()[_piece];
+			return piece.p[i - piece.begin];
+		}
+
+		/*append s[pos, pos + n) of the segments to res*/
+		void copy(std::size_t pos, std::size_t n, std::string& res) const {
+			while (n != 0) {
+				_piece = _segs->find(pos, _piece);
+				const InputSegments::Piece& piece = _segs->pieces()[_piece];
+				const std::size_t k = std::min(n, piece.n - (pos - piece.begin));
+				res.append(piece.p + (pos - piece.begin), k);
+				pos += k;
+				n -= k;
+			}
+		}
+
+		const char* _p = "";
+		std::size_t _n = 0;     /*bytes at _p (0: segments)*/
+		std::size_t _size = 0;
+		const InputSegments* _segs = nullptr;
+		mutable std::size_t _piece = 0; /*last piece found*/
+		const CEBNFBase* _skipper;
+		ParseError* _error = nullptr;
+	};
 
 	struct Tree {
-		static std::pair<std::vector<std::unique_ptr<SyntaxNode>>, std::size_t> Create(std::size_t token_id, std::string s, std::size_t len) {
-			std::vector<std::unique_ptr<SyntaxNode>> vec;
-			vec.emplace_back(new SyntaxNode(token_id, s));
-			return std::move(std::pair<std::vector<std::unique_ptr<SyntaxNode>>, std::size_t>(std::move(vec), len));
+		static SyntaxTree Create(std::size_t token_id, std::string s, std::size_t len) {
+			SyntaxNodeList vec;
+			vec.emplace_back(new SyntaxNode(token_id, s, 0, len));
+			return std::move(SyntaxTree(std::move(vec), len));
+		}
+		/*with the source position of the token*/
+		static SyntaxTree Create(std::size_t token_id, std::string s, std::size_t len, std::size_t begin) {
+			SyntaxNodeList vec;
+			vec.emplace_back(new SyntaxNode(token_id, std::move(s), begin, len));
+			return std::move(SyntaxTree(std::move(vec), len));
+		}
+		/*no match*/
+		static SyntaxTree Create() {
+			return SyntaxTree(SyntaxNodeList(), no_match);
 		}
-		static std::pair<std::vector<std::unique_ptr<SyntaxNode>>, std::size_t> Create() {
-			std::vector<std::unique_ptr<SyntaxNode>> vec;
-			return std::move(std::pair<std::vector<std::unique_ptr<SyntaxNode>>, std::size_t>(std::move(vec), 0));
+		/*matched len bytes without a node (dropped string), no allocation*/
+		static SyntaxTree Empty(std::size_t len) {
+			return SyntaxTree(SyntaxNodeList(), len);
+		}
+		/*one token of s[begin, begin + len) (no_match: empty tree)*/
+		static SyntaxTree Token(std::size_t token_id, const Input& s, std::size_t begin, std::size_t len) {
+			if (len == no_match) {
+				return Create();
+			}
+			return Create(token_id, s.substr(begin, len), len, begin);
+		}
+
+		/*no match (Create())*/
+		static bool Failed(const SyntaxTree& tree) {
+			return tree.second == no_match;
+		}
+
+		/*matched, but no node (epsilon, dropped string)*/
+		static bool IsEpsilon(const SyntaxTree& tree) {
+			return tree.first.size() == 0 ? tree.second != no_match : tree.first.size() == 1 && tree.first[0]->getTokenID() == cebnf_type::epsilon;
+		}
+
+		/*append matched src to matched dst. epsilon adds only its length*/
+		static void Merge(SyntaxTree& dst, SyntaxTree&& src) {
+			if (IsEpsilon(src)) {
+				dst.second += src.second;
+			}
+			else if (IsEpsilon(dst)) {
+				src.second += dst.second;
+				dst = std::move(src);
+			}
+			else {
+				SyntaxNode::append(dst.first, std::move(src.first));
+				dst.second += src.second;
+			}
 		}
 	};
 
 
 
-	enum cebnf_type {
-		base_begin = 10000000,
-		terminus,
-		epsilon,
-		base_end
+	/*expression of a rule for grammar tools (cebnf_grammar.hpp, cebnf_codegen.hpp)
+	- To / Or chains are flat (seq, alt of n children), Wrap is transparent
+	- rule: reference to a CEBNF (ref), its definition is CEBNFBase::describeRule
+	- primitive: helper token (Integer, StringIE2, CharSet, ...). text is the C++ expression that creates it, first the bytes a match starts with
+	- opaque: user defined expression (no description)
+	- node: inlined rule (GrammarInfo::optimize), creates the node of token_id around its child like the rule
+	- rule and node carry the tree shape of the rule (CEBNF::setShape)*/
+	struct GrammarExpr {
+		enum kind_t { opaque, rule, term, seq, alt, opt, rep, mul, lexeme, drop, pratt, primitive, node };
+
+		kind_t kind = opaque;
+		std::size_t token_id = 0;
+		std::string text;                         /*term: the string, primitive: constructor expression*/
+		unsigned int min = 0;                     /*rep, mul (count)*/
+		unsigned int max = 0;                     /*rep*/
+		std::array<std::uint64_t, 4> first = {};  /*primitive*/
+		const CEBNFBase* ref = nullptr;           /*rule, opaque*/
+		tree_shape shape = shape_keep;            /*rule, node*/
+		std::vector<GrammarExpr> children;
+
+		/*append e to a seq / alt (flattening nested ones of the same kind)*/
+		void add(GrammarExpr&& e) {
+			if (e.kind == kind) {
+				for (auto& c : e.children) children.push_back(std::move(c));
+			}
+			else {
+				children.push_back(std::move(e));
+			}
+		}
+
+		/*same expression (rules and opaque expressions by address)*/
+		bool operator==(const GrammarExpr& r) const {
+			return kind == r.kind && token_id == r.token_id && text == r.text && min == r.min && max == r.max
+				&& first == r.first && ref == r.ref && shape == r.shape && children == r.children;
+		}
+		bool operator!=(const GrammarExpr& r) const { return !(*this == r); }
+
+		/*number of expressions in the tree*/
+		std::size_t size() const {
+			std::size_t n = 1;
+			for (const auto& c : children) n += c.size();
+			return n;
+		}
 	};
 
 	struct CEBNFBase {
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) = 0;
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const = 0;
+
+		/*analysis mode: return only the matched length (or no_match), no node is created.
+		default is parse_impl and dropping the tree.*/
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const {
+			SyntaxTree&& tree = parse_impl(s, begin);
+			return Tree::Failed(tree) ? no_match : tree.second;
+		}
+
+		/*grammar tools: this expression (default opaque)*/
+		virtual void describe(GrammarExpr& e) const {
+			e.kind = GrammarExpr::opaque;
+			e.ref = this;
+		}
+
+		/*grammar tools, CEBNF only: definition and skipper of the rule (false if there is none)*/
+		virtual bool describeRule(GrammarExpr&) const { return false; }
+		virtual bool describeSkipper(GrammarExpr&) const { return false; }
+
 		virtual ~CEBNFBase(){}
 	};
 
+	inline std::size_t Input::skip(std::size_t pos) const {
+		if (_skipper == nullptr) {
+			return pos;
+		}
+
+		if (_error != nullptr) {
+			/*the skipper fails at every token: not a parse error*/
+			Input quiet(*this);
+			quiet._error = nullptr;
+			return quiet.skip(pos);
+		}
+
+		while (true) {
+			const std::size_t len = _skipper->match_impl(*this, pos);
+			if (len == no_match || len == 0) {
+				return pos;
+			}
+			pos += len;
+		}
+	}
+
+	inline bool SyntaxNode::expand() {
+		if (_lazy == nullptr) {
+			return true;
+		}
+		if (_lazy->failed) {
+			return false;
+		}
+
+		/*the node string is the span of the rule*/
+		const Input in(_s, _lazy->skipper);
+		SyntaxTree&& tree = _lazy->rule->parse_impl(in, 0);
+		if (Tree::Failed(tree) || tree.second != _s.size()) {
+			_lazy->failed = true;
+			return false;
+		}
+		_lazy.reset();
+		if (Tree::IsEpsilon(tree)) {
+			return true;
+		}
+
+		/*positions of the node string -> positions of the source*/
+		std::vector<SyntaxNode*> stack;
+		for (auto& c : tree.first) stack.push_back(c.get());
+		while (!stack.empty()) {
+			SyntaxNode* node = stack.back();
+			stack.pop_back();
+			node->_begin += _begin;
+			for (auto& c : node->children) stack.push_back(c.get());
+		}
+		mergeChildren(std::move(tree.first));
+		return true;
+	}
+
 	template<typename type>
 	using CEBNFBase_is_base_of_t = typename std::enable_if < std::is_base_of < CEBNFBase, typename std::remove_reference<type>::type>::value > ::type*;
 
 
 	/*value class*/
 
+	class Rule;
 	template<std::size_t TokenID>
 	class CEBNF;
 
 	struct Term;
+	template<char... Cs>
+	struct Literal;
 
 
 	/*operator class*/
@@ -112,10 +707,39 @@ namespace cebnf {
 	struct Mul;
 	template<class CEBNF_A>
 	struct Wrap;
+	template<class CEBNF_A>
+	struct Lexeme;
+	template<class CEBNF_A>
+	struct Drop;
+	template<class CEBNF_A>
+	struct Pratt;
 
 	struct tagValue {};
 	struct tagOperator{};
 
+	/*terminal: a value expression that is not a rule (CEBNF)*/
+	template<class T, class = void>
+	struct IsTerminal : std::is_base_of<tagValue, T> {};
+	template<class T>
+	struct IsTerminal<T, typename T::tagCEBNF> : std::false_type {};
+
+	/*calls of sub-expressions: a terminal that does not match is reported to the diagnostics of the parse (Input::fail)*/
+	struct Child {
+		template<class E>
+		static SyntaxTree parse(const E& e, const Input& s, const std::size_t begin) {
+			SyntaxTree tree = e.parse_impl(s, begin);
+			if (IsTerminal<E>::value && Tree::Failed(tree)) s.fail(begin, &e);
+			return tree;
+		}
+
+		template<class E>
+		static std::size_t match(const E& e, const Input& s, const std::size_t begin) {
+			const std::size_t len = e.match_impl(s, begin);
+			if (IsTerminal<E>::value && len == no_match) s.fail(begin, &e);
+			return len;
+		}
+	};
+
 
 	/*operator*/
 
@@ -139,18 +763,24 @@ namespace cebnf {
 		return Wrap<CEBNF_R>(std::forward<CEBNF_R>(r));
 	}
 
-	template<std::size_t TokenID>
-	class CEBNF : public CEBNFBase, tagValue {
-		friend class CEBNF<TokenID>;
+	/*rule of a grammar: a named expression that creates a node of its token id.
+	CEBNF<TokenID> is the rule of a token id known at compile time, Rule takes it at run time (grammars loaded from text, cebnf_ebnf.hpp)*/
+	class Rule : public CEBNFBase, tagValue {
 	public:
 		using tagCEBNF = void;
-		CEBNF(){}
+		explicit Rule(std::size_t token_id) : _token_id(token_id) {}
 
-		~CEBNF() {
+		~Rule() {
 			if (_func != nullptr) {
 				delete _func;
 				//std::cout << "delete _func" << std::endl;
 			}
+			if (_skipper != nullptr) {
+				delete _skipper;
+			}
+			if (_lazy_scan != nullptr) {
+				delete _lazy_scan;
+			}
 		}
 
 		//EBNF(EBNF const& eq) : _func(eq._func) {}
@@ -179,22 +809,148 @@ namespace cebnf {
 		//	return *this;
 		//}
 
+		/*rules are referenced by address from other expressions: not copyable (use +f)*/
+		Rule(Rule const&) = delete;
+		Rule& operator=(Rule const&) = delete;
+
+		template<typename CEBNF_EQ, CEBNFBase_is_base_of_t<CEBNF_EQ> = nullptr>
+		Rule& operator=(CEBNF_EQ const& eq) {
+			CEBNFBase* func = new CEBNF_EQ(eq);
+			if (_func != nullptr) {
+				delete _func;
+			}
+			_func = func;
+			_func_size = sizeof(CEBNF_EQ);
+			_func_terminal = IsTerminal<CEBNF_EQ>::value;
+			return *this;
+		}
+
+
+
+		/*skipper: insignificant string (spaces, comments, ...) skipped around the input and between the elements of To, Rep and Mul.
+		applies to parses started from this CEBNF. lexeme does not skip inside.
+		example: f.setSkipper(Span(CharSet(" \t\r\n")));*/
 		template<typename CEBNF_EQ, CEBNFBase_is_base_of_t<CEBNF_EQ> = nullptr>
-		CEBNF(CEBNF_EQ const& eq) {
-			_func = new CEBNF_EQ(eq);
+		Rule& setSkipper(CEBNF_EQ const& eq) {
+			if (_skipper != nullptr) {
+				delete _skipper;
+			}
+			_skipper = new CEBNF_EQ(eq);
+			_skipper_size = sizeof(CEBNF_EQ);
+			return *this;
+		}
+
+		/*lazy rule: parse creates the node of the span (its string, no children), children are parsed on the first SyntaxNode::expand().
+		- setLazy(): the span is found by the analysis mode of the rule (validated, no node is created)
+		- setLazy( ebnf ): the span is the match of ebnf, e.g. Balanced('{', '}') (structural scan, the content is checked on expand)
+		for consumers that visit only a part of large documents.*/
+		Rule& setLazy() {
+			if (_lazy_scan != nullptr) {
+				delete _lazy_scan;
+			}
+			_lazy_scan = nullptr;
+			_lazy_size = 0;
+			_lazy = true;
+			return *this;
 		}
 
 		template<typename CEBNF_EQ, CEBNFBase_is_base_of_t<CEBNF_EQ> = nullptr>
-		CEBNF& operator=(CEBNF_EQ const& eq) {
-			_func = new CEBNF_EQ(eq);
+		Rule& setLazy(CEBNF_EQ const& eq) {
+			setLazy();
+			_lazy_scan = new CEBNF_EQ(eq);
+			_lazy_size = sizeof(CEBNF_EQ);
+			_lazy_terminal = IsTerminal<CEBNF_EQ>::value;
 			return *this;
 		}
 
+		/*syntax tree shape of the rule where it is used (see tree_shape).
+		parse() of the rule itself always returns one node (shape_omit is shape_keep there), lazy rules keep their node.
+		example: f = g | h; f.setShape(shape_collapse); -> the node of g or h instead of f(g) or f(h)*/
+		Rule& setShape(tree_shape shape) {
+			_shape = shape;
+			return *this;
+		}
+
+		std::size_t getTokenID() const { return _token_id; }
+
+		/*skipper of parses started from this rule (nullptr: none)*/
+		const CEBNFBase* getSkipper() const { return _skipper; }
+
+		/*bytes of the expression objects owned by this rule (referenced rules are not included)*/
+		std::size_t memorySize() const {
+			return sizeof(*this) + _func_size + _skipper_size + _lazy_size;
+		}
+
+		std::unique_ptr<SyntaxNode> parse(const std::string& s) const {
+			return parseInput(Input(s, _skipper));
+		}
+
+		/*non-contiguous input (rope / piece table) without joining the pieces. one piece is read in place like a std::string*/
+		std::unique_ptr<SyntaxNode> parse(const InputSegments& segs) const {
+			return parseInput(Input(segs, _skipper));
+		}
+
+		/*same parse, error: the farthest failure (valid when nullptr is returned)*/
+		std::unique_ptr<SyntaxNode> parse(const std::string& s, ParseError& error) const {
+			error = ParseError();
+			return parseInput(Input(s, _skipper, &error));
+		}
+
+		std::unique_ptr<SyntaxNode> parse(const InputSegments& segs, ParseError& error) const {
+			error = ParseError();
+			return parseInput(Input(segs, _skipper, &error));
+		}
+
+		/*analysis mode: check the whole string without building the syntax tree*/
+		bool match(const std::string& s) const {
+			return matchInput(Input(s, _skipper));
+		}
+
+		bool match(const InputSegments& segs) const {
+			return matchInput(Input(segs, _skipper));
+		}
+
+
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return parseRule(s, begin, _shape);
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			const std::size_t len = (_lazy_scan != nullptr ? _lazy_scan : _func)->match_impl(s, begin);
+			if (len == no_match) failTerminal(s, begin);
+			return len;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			e.kind = GrammarExpr::rule;
+			e.token_id = _token_id;
+			e.ref = this;
+			e.shape = _lazy ? shape_keep : _shape;
+		}
+
+		virtual bool describeRule(GrammarExpr& def) const override {
+			if (_func == nullptr) return false;
+			_func->describe(def);
+			return true;
+		}
+
+		virtual bool describeSkipper(GrammarExpr& skipper) const override {
+			if (_skipper == nullptr) return false;
+			_skipper->describe(skipper);
+			return true;
+		}
 
+	private:
+		std::unique_ptr<SyntaxNode> parseInput(const Input& in) const {
+			const std::size_t begin = in.skip(0);
 
-		std::unique_ptr<SyntaxNode> parse(const std::string& s) {
-			SyntaxTree&& res_tree = parse_impl(s, 0);
-			if (res_tree.first.size() == 0 || res_tree.second != s.length()) {
+			SyntaxTree&& res_tree = parseRule(in, begin, _shape == shape_omit ? shape_keep : _shape);
+			if (Tree::Failed(res_tree)) {
+				return nullptr;
+			}
+			const std::size_t end = in.skip(begin + res_tree.second);
+			if (end != in.size()) {
+				in.fail(end, nullptr);
 				return nullptr;
 			}
 			else {
@@ -202,21 +958,80 @@ namespace cebnf {
 			}
 		}
 
+		bool matchInput(const Input& in) const {
+			const std::size_t begin = in.skip(0);
+
+			const std::size_t len = _func->match_impl(in, begin);
+			return len != no_match && in.skip(begin + len) == in.size();
+		}
+
+		SyntaxTree parseRule(const Input& s, const std::size_t begin, tree_shape shape) const {
+			if (_lazy) {
+				auto&& I = Tree::Token(_token_id, s, begin, match_impl(s, begin));
+				if (!Tree::Failed(I)) {
+					I.first[0]->setLazy(_func, s.skipper());
+				}
+				return std::move(I);
+			}
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
 			SyntaxTree&& children = _func->parse_impl(s, begin);
 
-			if (children.first.size() == 0) {
+			if (Tree::Failed(children)) {
+				failTerminal(s, begin);
 				return Tree::Create();
 			}
+			/*the length of the rule stays in children.second*/
+			if (shape == shape_omit || (shape == shape_collapse && children.first.size() == 1 && !Tree::IsEpsilon(children))) {
+				return std::move(children);
+			}
 
-			auto&& I = Tree::Create(TokenID, s.substr(begin, children.second), children.second);
-			I.first[0]->mergeChildren(std::move(children.first));
+			auto&& I = Tree::Create(_token_id, s.substr(begin, children.second), children.second, begin);
+			if (!Tree::IsEpsilon(children)) {
+				I.first[0]->mergeChildren(std::move(children.first));
+			}
 			return std::move(I);
 		}
 
-	private:
+		/*diagnostics: the expression of the rule is called through _func (not Child), report it here if it is a terminal*/
+		void failTerminal(const Input& s, const std::size_t begin) const {
+			if (_lazy_scan != nullptr ? _lazy_terminal : _func_terminal) s.fail(begin, _lazy_scan != nullptr ? _lazy_scan : _func);
+		}
+
+		std::size_t _token_id;
 		CEBNFBase* _func = nullptr;
+		CEBNFBase* _skipper = nullptr;
+		CEBNFBase* _lazy_scan = nullptr;
+		std::size_t _func_size = 0;
+		std::size_t _skipper_size = 0;
+		std::size_t _lazy_size = 0;
+		bool _func_terminal = false;
+		bool _lazy_terminal = false;
+		bool _lazy = false;
+		tree_shape _shape = shape_keep;
+	};
+
+	template<std::size_t TokenID>
+	class CEBNF : public Rule {
+	public:
+		CEBNF() : Rule(TokenID) {}
+
+		template<typename CEBNF_EQ, CEBNFBase_is_base_of_t<CEBNF_EQ> = nullptr>
+		CEBNF(CEBNF_EQ const& eq) : Rule(TokenID) {
+			*this = eq;
+		}
+
+		using Rule::operator=;
+	};
+
+	/*compiled grammar shared by any number of users
+	GrammarT: struct of CEBNF rules assigned in its constructor. built once on first use (thread-safe), then immutable.
+	get() is O(1) and does not allocate.*/
+	template<class GrammarT>
+	struct SharedGrammar {
+		static const std::shared_ptr<const GrammarT>& get() {
+			static const std::shared_ptr<const GrammarT> instance = std::make_shared<const GrammarT>();
+			return instance;
+		}
 	};
 
 	struct Term : public CEBNFBase, tagValue {
@@ -233,17 +1048,141 @@ namespace cebnf {
 		Term(const char*        s, std::size_t token_id) : _s(s)           , TokenID(token_id) {}
 
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
-			if (s.size() - begin >= _s.size() && std::equal(_s.begin(), _s.end(), s.begin() + begin)) {
-				return Tree::Create(TokenID, _s, _s.length());
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			if (s.equal(begin, _s.data(), _s.size())) {
+				return Tree::Create(TokenID, _s, _s.length(), begin);
 			}
 			else {
 				return Tree::Create();
 			}
 		}
 
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			if (s.equal(begin, _s.data(), _s.size())) {
+				return _s.length();
+			}
+			else {
+				return no_match;
+			}
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			e.kind = GrammarExpr::term;
+			e.token_id = TokenID;
+			e.text = _s;
+		}
+
 	};
 
+	/*compare L bytes with a literal known at compile time (8/4/2/1 byte integer compares)*/
+	template<std::size_t L>
+	struct LiteralCompare {
+		static bool equal(const char* p, const char* lit) {
+			if constexpr (L >= 8) {
+				std::uint64_t a, b;
+				std::memcpy(&a, p, 8);
+				std::memcpy(&b, lit, 8);
+				return a == b && LiteralCompare<L - 8>::equal(p + 8, lit + 8);
+			}
+			else if constexpr (L >= 4) {
+				std::uint32_t a, b;
+				std::memcpy(&a, p, 4);
+				std::memcpy(&b, lit, 4);
+				return a == b && LiteralCompare<L - 4>::equal(p + 4, lit + 4);
+			}
+			else if constexpr (L >= 2) {
+				std::uint16_t a, b;
+				std::memcpy(&a, p, 2);
+				std::memcpy(&b, lit, 2);
+				return a == b && LiteralCompare<L - 2>::equal(p + 2, lit + 2);
+			}
+			else {
+				return p[0] == lit[0];
+			}
+		}
+	};
+
+	template<>
+	struct LiteralCompare<0> {
+		static bool equal(const char*, const char*) { return true; }
+	};
+
+	/*compile-time Term
+	- Literal<'n', 'u', 'l', 'l'>() = Term("null");
+	(C++20: Lit<"null">())*/
+	template<char... Cs>
+	struct Literal : public CEBNFBase, tagValue {
+
+		static constexpr std::size_t length = sizeof...(Cs);
+		static constexpr char value[length + 1] = { Cs..., '\0' };
+
+		std::size_t TokenID = cebnf_type::terminus;
+
+		Literal() {}
+		Literal(std::size_t token_id) : TokenID(token_id) {}
+
+
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return Tree::Token(TokenID, s, begin, match_impl(s, begin));
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			if (!s.contiguous()) {
+				return s.equal(begin, value, length) ? length : no_match;
+			}
+			return (s.size() - begin >= length && LiteralCompare<length>::equal(s.data() + begin, value)) ? length : no_match;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			e.kind = GrammarExpr::term;
+			e.token_id = TokenID;
+			e.text.assign(value, length);
+		}
+	};
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+	/*string literal as a template argument*/
+	template<std::size_t N>
+	struct fixed_string {
+		char value[N] = {};
+
+		constexpr fixed_string(const char (&s)[N]) {
+			for (std::size_t i = 0; i < N; ++i) value[i] = s[i];
+		}
+
+		static constexpr std::size_t length = N - 1;
+	};
+
+	/*compile-time Term (C++20)
+	- Lit<"null">() = Term("null");*/
+	template<fixed_string S>
+	struct Lit : public CEBNFBase, tagValue {
+
+		std::size_t TokenID = cebnf_type::terminus;
+
+		Lit() {}
+		Lit(std::size_t token_id) : TokenID(token_id) {}
+
+
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return Tree::Token(TokenID, s, begin, match_impl(s, begin));
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			if (!s.contiguous()) {
+				return s.equal(begin, S.value, S.length) ? S.length : no_match;
+			}
+			return (s.size() - begin >= S.length && LiteralCompare<S.length>::equal(s.data() + begin, S.value)) ? S.length : no_match;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			e.kind = GrammarExpr::term;
+			e.token_id = TokenID;
+			e.text.assign(S.value, S.length);
+		}
+	};
+#endif
+
 	template<class CEBNF_A, class CEBNF_B>
 	struct To: public CEBNFBase, tagOperator {
 
@@ -255,34 +1194,52 @@ namespace cebnf {
 		To(To&& eq     )         : _a(std::forward<CEBNF_A>(eq._a)), _b(std::forward<CEBNF_B>(eq._b)) {}
 
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
-			SyntaxTree&& childrenA = _a.parse_impl(s, begin);
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			SyntaxTree&& childrenA = Child::parse(_a, s, begin);
 
-			if (childrenA.first.size() == 0) {
+			if (Tree::Failed(childrenA)) {
 				return Tree::Create();
 			}
 
 			//std::string sub_s = s.substr(childrenA.second);
-			SyntaxTree&& childrenB = _b.parse_impl(s, begin + childrenA.second);
+			const std::size_t posB = s.skip(begin + childrenA.second);
+			SyntaxTree&& childrenB = Child::parse(_b, s, posB);
 
-			if (childrenB.first.size() == 0) {
+			if (Tree::Failed(childrenB)) {
 				return Tree::Create();
 			}
 
-			if (childrenA.first[0]->getTokenID() == cebnf_type::epsilon) {
-				return std::move(childrenB);
+			/*skipped string is a part of To only if B is not empty*/
+			if (childrenB.second > 0) {
+				childrenA.second = posB - begin;
 			}
-			else if (childrenB.first[0]->getTokenID() == cebnf_type::epsilon) {
-				return std::move(childrenA);
+			Tree::Merge(childrenA, std::move(childrenB));
+			return std::move(childrenA);
+
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			const std::size_t lenA = Child::match(_a, s, begin);
+			if (lenA == no_match) {
+				return no_match;
 			}
-			else {
-				childrenA.first.reserve(childrenA.first.size() + childrenB.first.size());
-				std::move(childrenB.first.begin(), childrenB.first.end(), std::back_inserter(childrenA.first));
-				//childrenB.first->clear();
-				childrenA.second += childrenB.second;
-				return std::move(childrenA);
+
+			const std::size_t posB = s.skip(begin + lenA);
+			const std::size_t lenB = Child::match(_b, s, posB);
+			if (lenB == no_match) {
+				return no_match;
 			}
 
+			return lenB > 0 ? posB - begin + lenB : lenA;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarExpr a, b;
+			_a.describe(a);
+			_b.describe(b);
+			e.kind = GrammarExpr::seq;
+			e.add(std::move(a));
+			e.add(std::move(b));
 		}
 
 	};
@@ -298,16 +1255,16 @@ namespace cebnf {
 		Or(Or&& eq)              : _a(std::forward<CEBNF_A>(eq._a)), _b(std::forward<CEBNF_B>(eq._b)) {}
 
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
-			SyntaxTree&& childrenA = _a.parse_impl(s, begin);
-			SyntaxTree&& childrenB = _b.parse_impl(s, begin);
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			SyntaxTree&& childrenA = Child::parse(_a, s, begin);
+			SyntaxTree&& childrenB = Child::parse(_b, s, begin);
 
-			if (childrenA.first.size() == 0 && childrenB.first.size() == 0) {
+			if (Tree::Failed(childrenA) && Tree::Failed(childrenB)) {
 				return Tree::Create();
 			}
 
-			if (childrenA.first.size() > 0){
-				if (childrenB.first.size() > 0) {
+			if (!Tree::Failed(childrenA)){
+				if (!Tree::Failed(childrenB)) {
 
 					if (childrenA.second >= childrenB.second) {
 						return std::move(childrenA);
@@ -325,6 +1282,28 @@ namespace cebnf {
 
 		}
 
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			const std::size_t lenA = Child::match(_a, s, begin);
+			const std::size_t lenB = Child::match(_b, s, begin);
+
+			if (lenA == no_match) {
+				return lenB;
+			}
+			if (lenB == no_match || lenA >= lenB) {
+				return lenA;
+			}
+			return lenB;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarExpr a, b;
+			_a.describe(a);
+			_b.describe(b);
+			e.kind = GrammarExpr::alt;
+			e.add(std::move(a));
+			e.add(std::move(b));
+		}
+
 	};
 
 	template<class CEBNF_A>
@@ -337,47 +1316,108 @@ namespace cebnf {
 		May(May&& eq)      : _a(std::forward<CEBNF_A>(eq._a)) {}
 
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
-			SyntaxTree&& children = _a.parse_impl(s, begin);
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			SyntaxTree&& children = Child::parse(_a, s, begin);
 
-			if (children.first.size() == 0) {
+			if (Tree::Failed(children)) {
 				return Tree::Create(cebnf_type::epsilon, "", 0);
 			}
 			else {
 				return std::move(children);
 			}
 		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			const std::size_t len = Child::match(_a, s, begin);
+			return len == no_match ? 0 : len;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			e.kind = GrammarExpr::opt;
+			e.children.resize(1);
+			_a.describe(e.children[0]);
+		}
 	};
 
+	/*{ A } (zero or more), or between min and max repetitions: t(min, max, A)
+	- stops as soon as max repetitions are matched*/
 	template<class CEBNF_A>
 	struct Rep : public CEBNFBase, tagOperator {
 
+		unsigned int _min = 0;
+		unsigned int _max = static_cast<unsigned int>(-1);
 		CEBNF_A _a;
 
-		Rep(CEBNF_A a)     : _a(std::forward<CEBNF_A>(a))     {}
-		Rep(Rep const& eq) : _a(eq._a)                        {}
-		Rep(Rep&& eq)      : _a(std::forward<CEBNF_A>(eq._a)) {}
+		Rep(CEBNF_A a)                                     :                                _a(std::forward<CEBNF_A>(a))     {}
+		Rep(unsigned int min, unsigned int max, CEBNF_A a) : _min(min), _max(max)         , _a(std::forward<CEBNF_A>(a))     {}
+		Rep(Rep const& eq)                                 : _min(eq._min), _max(eq._max) , _a(eq._a)                        {}
+		Rep(Rep&& eq)                                      : _min(eq._min), _max(eq._max) , _a(std::forward<CEBNF_A>(eq._a)) {}
 
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
-			SyntaxTree&& children = _a.parse_impl(s, begin);
-
-			if (children.first.size() == 0) {
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			if (_max == 0) {
 				return Tree::Create(cebnf_type::epsilon, "", 0);
 			}
 
-			while (true) {
+			SyntaxTree&& children = Child::parse(_a, s, begin);
+
+			if (Tree::Failed(children)) {
+				return _min == 0 ? Tree::Create(cebnf_type::epsilon, "", 0) : Tree::Create();
+			}
+
+			unsigned int count = 1;
+			while (count < _max) {
 				//std::string sub_s = s.substr(children.second);
-				SyntaxTree&& childrenX = _a.parse_impl(s, begin + children.second);
+				const std::size_t posX = s.skip(begin + children.second);
+				SyntaxTree&& childrenX = Child::parse(_a, s, posX);
+
+				if (Tree::Failed(childrenX)) {
+					break;
+				}
+				if (childrenX.second > 0) {
+					children.second = posX - begin;
+				}
+				Tree::Merge(children, std::move(childrenX));
+				count++;
+			}
+
+			if (count < _min) {
+				return Tree::Create();
+			}
+			return std::move(children);
+		}
 
-				if (childrenX.first.size() == 0) {
-					return std::move(children);
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			if (_max == 0) {
+				return 0;
+			}
+
+			std::size_t len = Child::match(_a, s, begin);
+			if (len == no_match) {
+				return _min == 0 ? 0 : no_match;
+			}
+
+			unsigned int count = 1;
+			while (count < _max) {
+				const std::size_t posX = s.skip(begin + len);
+				const std::size_t lenX = Child::match(_a, s, posX);
+				if (lenX == no_match) {
+					break;
 				}
-				children.first.reserve(children.first.size() + childrenX.first.size());
-				std::move(childrenX.first.begin(), childrenX.first.end(), std::back_inserter(children.first));
-				//childrenX.first->clear();
-				children.second += childrenX.second;
+				if (lenX > 0) {
+					len = posX - begin + lenX;
+				}
+				count++;
 			}
+			return count < _min ? no_match : len;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			e.kind = GrammarExpr::rep;
+			e.min = _min;
+			e.max = _max;
+			e.children.resize(1);
+			_a.describe(e.children[0]);
 		}
 	};
 
@@ -392,33 +1432,54 @@ namespace cebnf {
 		Mul(Mul&& eq)                  : _n(eq._n), _a(std::forward<CEBNF_A>(eq._a)) {}
 
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
-			SyntaxTree&& children = _a.parse_impl(s, begin);
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			if (_n == 0) {
+				return Tree::Create(cebnf_type::epsilon, "", 0);
+			}
 
-			if (children.first.size() == 0) {
-				if (_n == 0) {
-					return Tree::Create(cebnf_type::epsilon, "", 0);
-				}
-				else {
-					return Tree::Create();
-				}
+			SyntaxTree&& children = Child::parse(_a, s, begin);
+			if (Tree::Failed(children)) {
+				return Tree::Create();
 			}
 
 			for (unsigned int i = 1; i < _n; ++i) {
-				SyntaxTree&& childrenX = _a.parse_impl(s, begin + children.second);
+				const std::size_t posX = s.skip(begin + children.second);
+				SyntaxTree&& childrenX = Child::parse(_a, s, posX);
 
-				if (childrenX.first.size() == 0) {
+				if (Tree::Failed(childrenX)) {
 					return Tree::Create();
 				}
 
-				children.first.reserve(children.first.size() + childrenX.first.size());
-				std::move(childrenX.first.begin(), childrenX.first.end(), std::back_inserter(children.first));
-				//childrenX.first->clear();
-				children.second += childrenX.second;
+				if (childrenX.second > 0) {
+					children.second = posX - begin;
+				}
+				Tree::Merge(children, std::move(childrenX));
 			}
 
 			return std::move(children);
 		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			std::size_t len = 0;
+			for (unsigned int i = 0; i < _n; ++i) {
+				const std::size_t posX = i == 0 ? begin : s.skip(begin + len);
+				const std::size_t lenX = Child::match(_a, s, posX);
+				if (lenX == no_match) {
+					return no_match;
+				}
+				if (lenX > 0) {
+					len = posX - begin + lenX;
+				}
+			}
+			return len;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			e.kind = GrammarExpr::mul;
+			e.min = _n;
+			e.children.resize(1);
+			_a.describe(e.children[0]);
+		}
 	};
 
 	template<class CEBNF_A>
@@ -431,8 +1492,245 @@ namespace cebnf {
 		Wrap(Wrap&& eq)      : _a(std::forward<CEBNF_A>(eq._a)) {}
 
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
-			return _a.parse_impl(s, begin);
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return Child::parse(_a, s, begin);
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			return Child::match(_a, s, begin);
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			_a.describe(e);
+		}
+	};
+
+	/*matches CEBNF_A in analysis mode (without the skipper) and creates one token of the matched string*/
+	template<class CEBNF_A>
+	struct Lexeme : public CEBNFBase, tagOperator {
+
+		std::size_t TokenID;
+		CEBNF_A _a;
+
+		Lexeme(CEBNF_A a, std::size_t token_id) : TokenID(token_id), _a(std::forward<CEBNF_A>(a))     {}
+		Lexeme(Lexeme const& eq)                 : TokenID(eq.TokenID), _a(eq._a)                        {}
+		Lexeme(Lexeme&& eq)                      : TokenID(eq.TokenID), _a(std::forward<CEBNF_A>(eq._a)) {}
+
+
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			const std::size_t len = Child::match(_a, s.noSkip(), begin);
+
+			if (len == no_match) {
+				return Tree::Create();
+			}
+			if (len == 0) {
+				return Tree::Create(cebnf_type::epsilon, "", 0);
+			}
+			return Tree::Create(TokenID, s.substr(begin, len), len, begin);
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			return Child::match(_a, s.noSkip(), begin);
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			e.kind = GrammarExpr::lexeme;
+			e.token_id = TokenID;
+			e.children.resize(1);
+			_a.describe(e.children[0]);
+		}
+	};
+
+	/*matches CEBNF_A in analysis mode and creates no node*/
+	template<class CEBNF_A>
+	struct Drop : public CEBNFBase, tagOperator {
+
+		CEBNF_A _a;
+
+		Drop(CEBNF_A a)      : _a(std::forward<CEBNF_A>(a))     {}
+		Drop(Drop const& eq) : _a(eq._a)                        {}
+		Drop(Drop&& eq)      : _a(std::forward<CEBNF_A>(eq._a)) {}
+
+
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			const std::size_t len = Child::match(_a, s, begin);
+
+			if (len == no_match) {
+				return Tree::Create();
+			}
+			return Tree::Empty(len);
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			return Child::match(_a, s, begin);
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			e.kind = GrammarExpr::drop;
+			e.children.resize(1);
+			_a.describe(e.children[0]);
+		}
+	};
+
+	/*binary operator of Pratt (higher precedence binds tighter)*/
+	struct PrattOperator {
+		enum associativity { left, right };
+
+		std::string symbol;
+		unsigned int precedence;
+		associativity assoc = left;
+		std::size_t token_id = cebnf_type::binary;
+	};
+
+	/*precedence climbing over binary operators: operand , { operator , operand }
+	- one loop with an operand stack and an operator stack (no rule per precedence level)
+	- each operator creates one node: token_id of the operator, string of the symbol, children { lhs, rhs },
+	  getBegin() / getLength() span the whole operation (the string is not copied per level)
+	- an operand of several nodes is grouped into one cebnf_type::operand node
+	example: t.pratt(+factor, { { "+", 10 }, { "-", 10 }, { "*", 20 }, { "^", 30, PrattOperator::right } })*/
+	template<class CEBNF_A>
+	struct Pratt : public CEBNFBase, tagOperator {
+
+		CEBNF_A _a;
+		std::vector<PrattOperator> _ops;
+
+		Pratt(CEBNF_A a, std::vector<PrattOperator> ops) : _a(std::forward<CEBNF_A>(a))    , _ops(std::move(ops)) { sortOperators(); }
+		Pratt(Pratt const& eq)                           : _a(eq._a)                       , _ops(eq._ops)        {}
+		Pratt(Pratt&& eq)                                : _a(std::forward<CEBNF_A>(eq._a)), _ops(std::move(eq._ops)) {}
+
+
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			struct Item {
+				std::unique_ptr<SyntaxNode> node;
+				std::size_t begin;
+				std::size_t end;
+			};
+
+			SyntaxTree&& first = Child::parse(_a, s, begin);
+			if (Tree::Failed(first)) {
+				return Tree::Create();
+			}
+
+			std::size_t end = begin + first.second;
+			const PrattOperator* op = nullptr;
+			std::size_t posX = 0;
+			SyntaxTree&& second = next(s, end, op, posX);
+			if (op == nullptr) {
+				/*no operator: the operand as it is*/
+				return std::move(first);
+			}
+
+			std::vector<Item> operands;
+			std::vector<const PrattOperator*> ops;
+			operands.push_back(Item{ group(s, std::move(first), begin), begin, end });
+
+			auto reduce = [&]() {
+				Item rhs = std::move(operands.back());
+				operands.pop_back();
+				Item& lhs = operands.back();
+				const PrattOperator* o = ops.back();
+				ops.pop_back();
+
+				std::unique_ptr<SyntaxNode> node(new SyntaxNode(o->token_id, o->symbol, lhs.begin, rhs.end - lhs.begin));
+				node->children.reserve(2);
+				node->children.push_back(std::move(lhs.node));
+				node->children.push_back(std::move(rhs.node));
+				lhs.node = std::move(node);
+				lhs.end = rhs.end;
+			};
+
+			while (op != nullptr) {
+				while (!ops.empty() && (ops.back()->precedence > op->precedence || (ops.back()->precedence == op->precedence && op->assoc == PrattOperator::left))) {
+					reduce();
+				}
+				end = posX + second.second;
+				ops.push_back(op);
+				operands.push_back(Item{ group(s, std::move(second), posX), posX, end });
+
+				second = next(s, end, op, posX);
+			}
+
+			while (!ops.empty()) {
+				reduce();
+			}
+
+			SyntaxNodeList vec;
+			vec.push_back(std::move(operands.back().node));
+			return SyntaxTree(std::move(vec), end - begin);
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			std::size_t len = Child::match(_a, s, begin);
+			if (len == no_match) {
+				return no_match;
+			}
+
+			while (true) {
+				const std::size_t posOp = s.skip(begin + len);
+				const PrattOperator* op = matchOperator(s, posOp);
+				if (op == nullptr) {
+					return len;
+				}
+
+				const std::size_t posX = s.skip(posOp + op->symbol.length());
+				const std::size_t lenX = Child::match(_a, s, posX);
+				if (lenX == no_match) {
+					return len;
+				}
+				len = posX - begin + lenX;
+			}
+		}
+
+		/*operand only (operators are not described)*/
+		virtual void describe(GrammarExpr& e) const override {
+			e.kind = GrammarExpr::pratt;
+			e.ref = this;
+			e.children.resize(1);
+			_a.describe(e.children[0]);
+		}
+
+	private:
+		/*longest symbols first*/
+		void sortOperators() {
+			std::stable_sort(_ops.begin(), _ops.end(), [](const PrattOperator& l, const PrattOperator& r) { return l.symbol.length() > r.symbol.length(); });
+		}
+
+		const PrattOperator* matchOperator(const Input& s, const std::size_t pos) const {
+			for (const auto& o : _ops) {
+				if (s.equal(pos, o.symbol.data(), o.symbol.size())) {
+					return &o;
+				}
+			}
+			return nullptr;
+		}
+
+		/*operator , operand after end. op == nullptr if there is none (the operator is not consumed)*/
+		SyntaxTree next(const Input& s, const std::size_t end, const PrattOperator*& op, std::size_t& posX) const {
+			const std::size_t posOp = s.skip(end);
+			op = matchOperator(s, posOp);
+			if (op == nullptr) {
+				return Tree::Create();
+			}
+
+			posX = s.skip(posOp + op->symbol.length());
+			SyntaxTree&& operand = Child::parse(_a, s, posX);
+			if (Tree::Failed(operand)) {
+				op = nullptr;
+			}
+			return std::move(operand);
+		}
+
+		/*operand tree -> one node*/
+		static std::unique_ptr<SyntaxNode> group(const Input& s, SyntaxTree&& tree, const std::size_t pos) {
+			if (tree.first.size() == 1 && !Tree::IsEpsilon(tree)) {
+				return std::move(tree.first[0]);
+			}
+
+			std::unique_ptr<SyntaxNode> node(new SyntaxNode(cebnf_type::operand, s.substr(pos, tree.second), pos, tree.second));
+			if (!Tree::IsEpsilon(tree)) {
+				node->mergeChildren(std::move(tree.first));
+			}
+			return node;
 		}
 	};
 
@@ -466,6 +1764,32 @@ namespace cebnf {
 			return Rep<CEBNF_C>(std::move(*(c.begin())));
 		}
 
+		/*{m,n} :: t(m, n, c) or t(m, n, { c })*/
+		template<class CEBNF_C, CEBNFBase_is_base_of_t<CEBNF_C> = nullptr>
+		Rep<CEBNF_C> operator()(unsigned int min, unsigned int max, CEBNF_C&& c) {
+			return Rep<CEBNF_C>(min, max, std::forward<CEBNF_C>(c));
+		}
+
+		template<class CEBNF_C, CEBNFBase_is_base_of_t<CEBNF_C> = nullptr>
+		Rep<CEBNF_C> operator()(unsigned int min, unsigned int max, std::initializer_list<CEBNF_C> c) {
+			return Rep<CEBNF_C>(min, max, std::move(*(c.begin())));
+		}
+
+		template<class CEBNF_C, CEBNFBase_is_base_of_t<CEBNF_C> = nullptr>
+		Lexeme<CEBNF_C> lexeme(CEBNF_C&& c, std::size_t token_id = cebnf_type::lexeme) {
+			return Lexeme<CEBNF_C>(std::forward<CEBNF_C>(c), token_id);
+		}
+
+		template<class CEBNF_C, CEBNFBase_is_base_of_t<CEBNF_C> = nullptr>
+		Drop<CEBNF_C> drop(CEBNF_C&& c) {
+			return Drop<CEBNF_C>(std::forward<CEBNF_C>(c));
+		}
+
+		template<class CEBNF_C, CEBNFBase_is_base_of_t<CEBNF_C> = nullptr>
+		Pratt<CEBNF_C> pratt(CEBNF_C&& c, std::vector<PrattOperator> ops) {
+			return Pratt<CEBNF_C>(std::forward<CEBNF_C>(c), std::move(ops));
+		}
+
 	};
 	
 
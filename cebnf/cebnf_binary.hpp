@@ -0,0 +1,278 @@
+#pragma once
+
+
+#include "cebnf.hpp"
+#include "cebnf_mmap.hpp"
+
+#include <ostream>
+#include <fstream>
+#include <string_view>
+#include <cstdint>
+
+/*binary syntax tree
+
+file  :: "CEBT" , version(1 byte) , varint node_count , varint source_length , node
+node  :: varint token_id , varint zigzag(begin delta) , varint length , varint string , varint child_count , varint children_bytes , { node }
+- begin delta: first child from the parent begin, other nodes from the previous sibling begin (root: from 0)
+- string: 0 if the node string equals source[begin, begin + length), else (string length + 1) followed by the bytes
+- children_bytes: size of all child records, so a subtree is skipped without decoding it
+
+Loading (BinaryTreeView over a MappedFile or any buffer) only checks the header.
+Nodes are decoded when they are visited.
+*/
+namespace cebnf {
+
+	namespace varint {
+
+		inline void write(std::string& dst, std::uint64_t v) {
+			while (v >= 0x80) {
+				dst += static_cast<char>((v & 0x7F) | 0x80);
+				v >>= 7;
+			}
+			dst += static_cast<char>(v);
+		}
+
+		inline std::size_t size(std::uint64_t v) {
+			std::size_t n = 1;
+			while (v >= 0x80) { v >>= 7; ++n; }
+			return n;
+		}
+
+		/*p is advanced. false if the varint runs past end*/
+		inline bool read(const char*& p, const char* end, std::uint64_t& v) {
+			v = 0;
+			for (unsigned int shift = 0; p < end && shift < 64; shift += 7) {
+				const unsigned char c = static_cast<unsigned char>(*p++);
+				v |= static_cast<std::uint64_t>(c & 0x7F) << shift;
+				if ((c & 0x80) == 0) return true;
+			}
+			return false;
+		}
+
+		inline std::uint64_t zigzag(std::int64_t v) {
+			return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+		}
+		inline std::int64_t unzigzag(std::uint64_t v) {
+			return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+		}
+
+	}
+
+	/*node cursor in a binary tree (decodes only its own record)*/
+	class BinaryNode {
+		friend class BinaryTreeView;
+	public:
+		BinaryNode() {}
+
+		explicit operator bool() const { return _p != nullptr; }
+
+		std::size_t getTokenID() const { return _token_id; }
+		std::size_t getBegin() const { return _begin; }
+		std::size_t getLength() const { return _length; }
+		std::size_t childCount() const { return _child_count; }
+
+		/*node string: stored bytes, or the span of the source*/
+		std::string_view getString(std::string_view source) const {
+			if (_string != nullptr) return std::string_view(_string, _string_length);
+			if (_begin + _length > source.size()) return std::string_view();
+			return source.substr(_begin, _length);
+		}
+
+		BinaryNode firstChild() const {
+			if (_child_count == 0) return BinaryNode();
+			return BinaryNode(_children, _children + _children_bytes, _begin, _child_count);
+		}
+
+		BinaryNode nextSibling() const {
+			if (_siblings_left <= 1) return BinaryNode();
+			return BinaryNode(_children + _children_bytes, _end, _begin, _siblings_left - 1);
+		}
+
+		/*O(i)*/
+		BinaryNode child(std::size_t i) const {
+			BinaryNode c = firstChild();
+			while (c && i-- > 0) c = c.nextSibling();
+			return c;
+		}
+
+	private:
+		BinaryNode(const char* p, const char* end, std::size_t base, std::size_t siblings_left) : _end(end), _siblings_left(siblings_left) {
+			std::uint64_t token_id, delta, length, string, child_count, children_bytes;
+			if (!varint::read(p, end, token_id) || !varint::read(p, end, delta) || !varint::read(p, end, length) || !varint::read(p, end, string)) return;
+			if (string > 0) {
+				if (static_cast<std::uint64_t>(end - p) < string - 1) return;
+				_string = p;
+				_string_length = static_cast<std::size_t>(string - 1);
+				p += _string_length;
+			}
+			if (!varint::read(p, end, child_count) || !varint::read(p, end, children_bytes)) return;
+			if (static_cast<std::uint64_t>(end - p) < children_bytes) return;
+
+			_token_id = static_cast<std::size_t>(token_id);
+			_begin = static_cast<std::size_t>(static_cast<std::int64_t>(base) + varint::unzigzag(delta));
+			_length = static_cast<std::size_t>(length);
+			_child_count = static_cast<std::size_t>(child_count);
+			_children = p;
+			_children_bytes = static_cast<std::size_t>(children_bytes);
+			_p = p;
+		}
+
+		const char* _p = nullptr;
+		const char* _end = nullptr;
+		const char* _children = nullptr;
+		const char* _string = nullptr;
+		std::size_t _string_length = 0;
+		std::size_t _children_bytes = 0;
+		std::size_t _siblings_left = 0;
+
+		std::size_t _token_id = 0;
+		std::size_t _begin = 0;
+		std::size_t _length = 0;
+		std::size_t _child_count = 0;
+	};
+
+	/*read-only view of an encoded tree (the buffer must outlive the view)*/
+	class BinaryTreeView {
+	public:
+		BinaryTreeView() {}
+		BinaryTreeView(const char* data, std::size_t size) {
+			const char* end = data + size;
+			if (size < 5 || std::string(data, 4) != "CEBT" || data[4] != version) return;
+
+			const char* p = data + 5;
+			std::uint64_t node_count, source_length;
+			if (!varint::read(p, end, node_count) || !varint::read(p, end, source_length)) return;
+
+			_node_count = static_cast<std::size_t>(node_count);
+			_source_length = static_cast<std::size_t>(source_length);
+			_root = BinaryNode(p, end, 0, 1);
+		}
+		BinaryTreeView(const MappedFile& file) : BinaryTreeView(file.data(), file.size()) {}
+
+		bool valid() const { return static_cast<bool>(_root); }
+		std::size_t nodeCount() const { return _node_count; }
+		std::size_t sourceLength() const { return _source_length; }
+		BinaryNode root() const { return _root; }
+
+		/*build SyntaxNodes (per-node work, for code that needs the pointer tree)*/
+		std::unique_ptr<SyntaxNode> toSyntaxNode(std::string_view source) const {
+			if (!valid()) return nullptr;
+
+			std::unique_ptr<SyntaxNode> root(create(_root, source));
+			std::vector<std::pair<SyntaxNode*, BinaryNode>> stack;
+			stack.emplace_back(root.get(), _root.firstChild());
+
+			while (!stack.empty()) {
+				BinaryNode& cur = stack.back().second;
+				if (!cur) {
+					stack.pop_back();
+					continue;
+				}
+				SyntaxNode* parent = stack.back().first;
+				parent->children.emplace_back(create(cur, source));
+				SyntaxNode* node = parent->children.back().get();
+				BinaryNode first = cur.firstChild();
+				cur = cur.nextSibling();
+				stack.emplace_back(node, first);
+			}
+			return root;
+		}
+
+		static constexpr char version = 1;
+
+	private:
+		static SyntaxNode* create(const BinaryNode& n, std::string_view source) {
+			const std::string_view s = n.getString(source);
+			return new SyntaxNode(n.getTokenID(), std::string(s.data(), s.size()), n.getBegin(), n.getLength());
+		}
+
+		BinaryNode _root;
+		std::size_t _node_count = 0;
+		std::size_t _source_length = 0;
+	};
+
+	struct BinaryTree {
+
+		/*source: the parsed string. node strings equal to their source span are not stored (empty source: all are stored)*/
+		static std::string encode(const std::unique_ptr<SyntaxNode>& root, const std::string& source = std::string()) {
+			struct Record {
+				const SyntaxNode* node;
+				std::size_t parent;
+				std::uint64_t delta;
+				bool store_string;
+				std::size_t children_bytes;
+				std::size_t record_bytes;
+			};
+
+			/*preorder records (explicit stack)*/
+			const std::size_t none = static_cast<std::size_t>(-1);
+			std::vector<Record> records;
+			std::vector<std::pair<std::size_t, std::size_t>> stack; /*record, next child*/
+
+			records.push_back(Record{ root.get(), none, varint::zigzag(static_cast<std::int64_t>(root->getBegin())), false, 0, 0 });
+			stack.emplace_back(0, 0);
+			while (!stack.empty()) {
+				const std::size_t r = stack.back().first;
+				const std::size_t i = stack.back().second++;
+				const SyntaxNode* node = records[r].node;
+				if (i >= node->children.size()) {
+					stack.pop_back();
+					continue;
+				}
+				const SyntaxNode* child = node->children[i].get();
+				const std::size_t base = i == 0 ? node->getBegin() : node->children[i - 1]->getBegin();
+				records.push_back(Record{ child, r, varint::zigzag(static_cast<std::int64_t>(child->getBegin()) - static_cast<std::int64_t>(base)), false, 0, 0 });
+				stack.emplace_back(records.size() - 1, 0);
+			}
+
+			/*sizes bottom-up (children come after their parent in preorder)*/
+			for (std::size_t r = records.size(); r-- > 0;) {
+				Record& rec = records[r];
+				const SyntaxNode* node = rec.node;
+				const std::string& s = node->getString();
+				rec.store_string = !(node->getBegin() + node->getLength() <= source.size() && s.size() == node->getLength() && source.compare(node->getBegin(), node->getLength(), s) == 0);
+
+				const std::uint64_t string = rec.store_string ? s.size() + 1 : 0;
+				rec.record_bytes = varint::size(node->getTokenID()) + varint::size(rec.delta) + varint::size(node->getLength())
+					+ varint::size(string) + (rec.store_string ? s.size() : 0)
+					+ varint::size(node->children.size()) + varint::size(rec.children_bytes) + rec.children_bytes;
+				if (rec.parent != none) records[rec.parent].children_bytes += rec.record_bytes;
+			}
+
+			std::string dst("CEBT");
+			dst += BinaryTreeView::version;
+			varint::write(dst, records.size());
+			varint::write(dst, source.size());
+			dst.reserve(dst.size() + records[0].record_bytes);
+
+			for (const Record& rec : records) {
+				const SyntaxNode* node = rec.node;
+				varint::write(dst, node->getTokenID());
+				varint::write(dst, rec.delta);
+				varint::write(dst, node->getLength());
+				if (rec.store_string) {
+					varint::write(dst, node->getString().size() + 1);
+					dst += node->getString();
+				}
+				else {
+					varint::write(dst, 0);
+				}
+				varint::write(dst, node->children.size());
+				varint::write(dst, rec.children_bytes);
+			}
+			return dst;
+		}
+
+		static bool write(std::ostream& os, const std::unique_ptr<SyntaxNode>& root, const std::string& source = std::string()) {
+			const std::string bin = encode(root, source);
+			os.write(bin.data(), static_cast<std::streamsize>(bin.size()));
+			return static_cast<bool>(os);
+		}
+
+		static bool writeFile(const std::string& path, const std::unique_ptr<SyntaxNode>& root, const std::string& source = std::string()) {
+			std::ofstream ofs(path, std::ios::binary);
+			return ofs && write(ofs, root, source);
+		}
+	};
+
+}
@@ -0,0 +1,481 @@
+#pragma once
+
+
+#include "cebnf.hpp"
+#include "cebnf_grammar.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*parser generator: grammar -> standalone recursive descent C++ header
+
+The generated header has one function pair (parse / match) per expression of the grammar:
+- no virtual calls between expressions, terms are inline compares, helper tokens are called on static objects
+- alternatives are tried only when the input byte is in their FIRST set (switch on the byte)
+- parse(s) / match(s) of the generated namespace return the same as CEBNF::parse / CEBNF::match of the start rule
+  (same syntax tree: token ids, strings, positions)
+- the grammar is optimized first (GrammarInfo::optimize): small rules are inlined, common prefixes of alternatives are parsed once
+Lazy rules (CEBNF::setLazy) are parsed eagerly (the tree of an expanded lazy node).
+Not supported: pratt and user defined expressions (generate() returns false, see error()).
+
+example (tool):
+	cebnf::CodeGenerator gen(grammar._jbase, { "frijson_generated", "../cebnf/", "frijson_grammar.hpp" });
+	std::string code;
+	if (gen.generate(code)) write code to the header
+*/
+namespace cebnf {
+
+	struct CodeGenOptions {
+		std::string name_space = "generated";
+		std::string include_prefix = "";   /*path of the cebnf headers from the generated header*/
+		std::string source = "";           /*comment: origin of the grammar*/
+		bool optimize = true;              /*GrammarInfo::optimize before the generation*/
+	};
+
+	class CodeGenerator {
+	public:
+		CodeGenerator(const CEBNFBase& start, CodeGenOptions options) : _info(start), _options(std::move(options)) {
+			if (_options.optimize) _info.optimize();
+		}
+
+		const std::string& error() const { return _error; }
+
+		bool generate(std::string& out) {
+			_error.clear();
+			_ids.clear();
+			_prims.clear();
+			_decls.clear();
+			_defs.clear();
+			_prim_defs.clear();
+
+			const auto& rules = _info.rules();
+			if (rules.empty() || rules[0].ref == nullptr || _info.ruleIndex(rules[0].ref) != 0) {
+				_error = "the start must be a CEBNF rule";
+				return false;
+			}
+
+			const std::vector<bool> used = usedRules();
+			for (std::size_t k = 0; k < rules.size(); ++k) {
+				if (!used[k]) continue;
+				if (!rules[k].defined) {
+					_error = "rule " + std::to_string(k) + " (token id " + std::to_string(rules[k].token_id) + ") is not defined";
+					return false;
+				}
+				if (!emit(rules[k].def)) return false;
+				emitRule(k);
+			}
+			if (_info.hasSkipper() && !emit(_info.skipper())) return false;
+			/*parse() returns one node (shape_omit of the start rule is shape_keep there, same as CEBNF::parse)*/
+			const bool root = rules[0].shape == shape_omit;
+			if (root) emitNode("root", rules[0].token_id, rules[0].def, shape_keep);
+
+			out.clear();
+			out += "#pragma once\n\n";
+			out += "/*generated by cebnf::CodeGenerator" + (_options.source.empty() ? std::string() : " from " + _options.source) + ". do not edit.*/\n\n";
+			out += "#include \"" + _options.include_prefix + "cebnf.hpp\"\n";
+			out += "#include \"" + _options.include_prefix + "cebnf_helper.hpp\"\n\n";
+			out += "#include <cstring>\n#include <memory>\n#include <string>\n\n";
+			out += "namespace " + _options.name_space + " {\n\n";
+			out += "\tnamespace detail {\n\n";
+			out += "\t\tstruct Ctx {\n"
+				"\t\t\tconst std::string* str;\n"
+				"\t\t\tconst char* p;\n"
+				"\t\t\tstd::size_t n;\n"
+				"\t\t\tconst cebnf::Input* raw; /*input of the helper tokens*/\n"
+				"\t\t\tbool skip;\n"
+				"\t\t};\n\n";
+			out += "\t\tinline Ctx noSkip(const Ctx& c) {\n\t\t\tCtx res = c;\n\t\t\tres.skip = false;\n\t\t\treturn res;\n\t\t}\n\n";
+			out += "\t\tinline std::size_t skip(const Ctx& c, std::size_t pos);\n";
+			out += _decls + "\n";
+			out += _prim_defs + "\n";
+			out += "\t\tinline std::size_t skip(const Ctx& c, std::size_t pos) {\n";
+			if (_info.hasSkipper()) {
+				out += "\t\t\tif (!c.skip) return pos;\n"
+					"\t\t\twhile (true) {\n"
+					"\t\t\t\tconst std::size_t len = " + call(_info.skipper(), false) + "(c, pos);\n"
+					"\t\t\t\tif (len == cebnf::no_match || len == 0) return pos;\n"
+					"\t\t\t\tpos += len;\n"
+					"\t\t\t}\n";
+			}
+			else {
+				out += "\t\t\treturn pos;\n";
+			}
+			out += "\t\t}\n\n";
+			out += _defs;
+			out += "\t}\n\n";
+			out += "\t/*same as CEBNF::parse of the start rule*/\n"
+				"\tinline std::unique_ptr<cebnf::SyntaxNode> parse(const std::string& s) {\n"
+				"\t\tconst cebnf::Input raw(s);\n"
+				"\t\tconst detail::Ctx c{ &s, s.data(), s.size(), &raw, true };\n"
+				"\t\tconst std::size_t begin = detail::skip(c, 0);\n\n"
+				"\t\tcebnf::SyntaxTree tree = detail::" + std::string(root ? "root" : "r0") + "_parse(c, begin);\n"
+				"\t\tif (cebnf::Tree::Failed(tree) || detail::skip(c, begin + tree.second) != s.length()) {\n"
+				"\t\t\treturn nullptr;\n"
+				"\t\t}\n"
+				"\t\treturn std::move(tree.first[0]);\n"
+				"\t}\n\n";
+			out += "\t/*same as CEBNF::match of the start rule*/\n"
+				"\tinline bool match(const std::string& s) {\n"
+				"\t\tconst cebnf::Input raw(s);\n"
+				"\t\tconst detail::Ctx c{ &s, s.data(), s.size(), &raw, true };\n"
+				"\t\tconst std::size_t begin = detail::skip(c, 0);\n\n"
+				"\t\tconst std::size_t len = detail::r0_match(c, begin);\n"
+				"\t\treturn len != cebnf::no_match && detail::skip(c, begin + len) == s.length();\n"
+				"\t}\n\n";
+			out += "}\n";
+			return true;
+		}
+
+		/*C++ string literal of s (octal escapes for other than printable ASCII)*/
+		static std::string literal(const std::string& s) {
+			std::string res = "\"";
+			for (const char ch : s) {
+				const unsigned char u = static_cast<unsigned char>(ch);
+				if (u == '"' || u == '\\') {
+					res += '\\';
+					res += ch;
+				}
+				else if (0x20 <= u && u < 0x7F && u != '?') {
+					res += ch;
+				}
+				else {
+					res += '\\';
+					res += static_cast<char>('0' + (u >> 6));
+					res += static_cast<char>('0' + ((u >> 3) & 7));
+					res += static_cast<char>('0' + (u & 7));
+				}
+			}
+			return res + "\"";
+		}
+
+	private:
+		static std::string u(std::size_t v) { return std::to_string(v) + "u"; }
+
+		/*case label of an unsigned char*/
+		static std::string byteLiteral(std::size_t b) {
+			if (0x20 <= b && b < 0x7F && b != '\'' && b != '\\') return std::string("'") + static_cast<char>(b) + "'";
+			return std::to_string(b);
+		}
+
+		/*function called for e (rule references call the rule)*/
+		std::string call(const GrammarExpr& e, bool parse) const {
+			if (e.kind == GrammarExpr::rule) {
+				return "r" + std::to_string(_info.ruleIndex(e.ref)) + (parse ? "_parse" : "_match");
+			}
+			return "e" + std::to_string(_ids.at(&e)) + (parse ? "_parse" : "_match");
+		}
+
+		void function(const std::string& name, bool parse, const std::string& body) {
+			const std::string head = std::string("\t\tinline ") + (parse ? "cebnf::SyntaxTree " : "std::size_t ") + name + "(const Ctx& c, const std::size_t begin)";
+			_decls += head + ";\n";
+			_defs += head + " {\n" + body + "\t\t}\n\n";
+		}
+
+		/*rules referenced from the start rule and the skipper (inlined rules are not)*/
+		std::vector<bool> usedRules() const {
+			const auto& rules = _info.rules();
+			std::vector<bool> used(rules.size(), false);
+			std::vector<const GrammarExpr*> exprs(1, &rules[0].def);
+			used[0] = true;
+			if (_info.hasSkipper()) exprs.push_back(&_info.skipper());
+			while (!exprs.empty()) {
+				const GrammarExpr* e = exprs.back();
+				exprs.pop_back();
+				if (e->kind == GrammarExpr::rule) {
+					const std::size_t k = _info.ruleIndex(e->ref);
+					if (!used[k]) {
+						used[k] = true;
+						exprs.push_back(&rules[k].def);
+					}
+					continue;
+				}
+				for (const auto& c : e->children) exprs.push_back(&c);
+			}
+			return used;
+		}
+
+		/*node of token_id around the tree of def (rules and inlined rules), shaped like CEBNF::setShape*/
+		void emitNode(const std::string& name, std::size_t token_id, const GrammarExpr& def, tree_shape shape) {
+			if (shape == shape_omit) {
+				function(name + "_parse", true, "\t\t\treturn " + call(def, true) + "(c, begin);\n");
+				function(name + "_match", false, "\t\t\treturn " + call(def, false) + "(c, begin);\n");
+				return;
+			}
+			function(name + "_parse", true,
+				"\t\t\tcebnf::SyntaxTree children = " + call(def, true) + "(c, begin);\n"
+				"\t\t\tif (cebnf::Tree::Failed(children)) return cebnf::Tree::Create();\n"
+				+ (shape == shape_collapse ? "\t\t\tif (children.first.size() == 1 && !cebnf::Tree::IsEpsilon(children)) return children;\n" : "") +
+				"\n"
+				"\t\t\tcebnf::SyntaxTree res = cebnf::Tree::Create(" + u(token_id) + ", c.str->substr(begin, children.second), children.second, begin);\n"
+				"\t\t\tif (!cebnf::Tree::IsEpsilon(children)) res.first[0]->mergeChildren(std::move(children.first));\n"
+				"\t\t\treturn res;\n");
+			function(name + "_match", false,
+				"\t\t\treturn " + call(def, false) + "(c, begin);\n");
+		}
+
+		void emitRule(std::size_t k) {
+			const auto& r = _info.rules()[k];
+			emitNode("r" + std::to_string(k), r.token_id, r.def, r.shape);
+		}
+
+		/*functions of e and its children (post order)*/
+		bool emit(const GrammarExpr& e) {
+			if (e.kind == GrammarExpr::rule) return true;
+			if (e.kind == GrammarExpr::opaque || e.kind == GrammarExpr::pratt) {
+				_error = e.kind == GrammarExpr::pratt ? "pratt is not supported" : "user defined expression is not supported";
+				return false;
+			}
+			for (const auto& c : e.children) {
+				if (!emit(c)) return false;
+			}
+
+			const std::size_t id = _ids.size();
+			_ids[&e] = id;
+			const std::string name = "e" + std::to_string(id);
+			const std::string fail = "cebnf::Tree::Create()";
+			const std::string eps = "cebnf::Tree::Create(cebnf::cebnf_type::epsilon, \"\", 0)";
+			const std::string unused = "\t\t\tstatic_cast<void>(c);\n\t\t\tstatic_cast<void>(begin);\n";
+
+			switch (e.kind) {
+			case GrammarExpr::term: {
+				const std::string len = std::to_string(e.text.size());
+				const std::string lit = literal(e.text);
+				const std::string cond = "c.n - begin >= " + len + " && std::memcmp(c.p + begin, " + lit + ", " + len + ") == 0";
+				function(name + "_parse", true,
+					"\t\t\tif (" + cond + ") return cebnf::Tree::Create(" + u(e.token_id) + ", std::string(" + lit + ", " + len + "), " + len + ", begin);\n"
+					"\t\t\treturn " + fail + ";\n");
+				function(name + "_match", false,
+					"\t\t\treturn (" + cond + ") ? " + len + " : cebnf::no_match;\n");
+				break;
+			}
+			case GrammarExpr::primitive: {
+				const auto key = std::make_pair(e.text, e.token_id);
+				auto itr = _prims.find(key);
+				if (itr == _prims.end()) {
+					itr = _prims.emplace(key, "prim" + std::to_string(_prims.size())).first;
+					_prim_defs += "\t\tinline const auto " + itr->second + " = [] {\n"
+						"\t\t\tauto res = " + e.text + ";\n"
+						"\t\t\tres.TokenID = " + u(e.token_id) + ";\n"
+						"\t\t\treturn res;\n"
+						"\t\t}();\n";
+				}
+				function(name + "_parse", true, "\t\t\treturn " + itr->second + ".parse_impl(*c.raw, begin);\n");
+				function(name + "_match", false, "\t\t\treturn " + itr->second + ".match_impl(*c.raw, begin);\n");
+				break;
+			}
+			case GrammarExpr::seq: {
+				std::string p = "\t\t\tcebnf::SyntaxTree res = " + call(e.children[0], true) + "(c, begin);\n"
+					"\t\t\tif (cebnf::Tree::Failed(res)) return " + fail + ";\n";
+				std::string m = "\t\t\tstd::size_t len = " + call(e.children[0], false) + "(c, begin);\n"
+					"\t\t\tif (len == cebnf::no_match) return cebnf::no_match;\n";
+				for (std::size_t i = 1; i < e.children.size(); ++i) {
+					p += "\t\t\t{\n"
+						"\t\t\t\tconst std::size_t pos = skip(c, begin + res.second);\n"
+						"\t\t\t\tcebnf::SyntaxTree x = " + call(e.children[i], true) + "(c, pos);\n"
+						"\t\t\t\tif (cebnf::Tree::Failed(x)) return " + fail + ";\n"
+						"\t\t\t\tif (x.second > 0) res.second = pos - begin;\n"
+						"\t\t\t\tcebnf::Tree::Merge(res, std::move(x));\n"
+						"\t\t\t}\n";
+					m += "\t\t\t{\n"
+						"\t\t\t\tconst std::size_t pos = skip(c, begin + len);\n"
+						"\t\t\t\tconst std::size_t x = " + call(e.children[i], false) + "(c, pos);\n"
+						"\t\t\t\tif (x == cebnf::no_match) return cebnf::no_match;\n"
+						"\t\t\t\tif (x > 0) len = pos - begin + x;\n"
+						"\t\t\t}\n";
+				}
+				function(name + "_parse", true, p + "\t\t\treturn res;\n");
+				function(name + "_match", false, m + "\t\t\treturn len;\n");
+				break;
+			}
+			case GrammarExpr::alt:
+				emitAlt(name, e);
+				break;
+			case GrammarExpr::node:
+				emitNode(name, e.token_id, e.children[0], e.shape);
+				break;
+			case GrammarExpr::opt:
+				function(name + "_parse", true,
+					"\t\t\tcebnf::SyntaxTree res = " + call(e.children[0], true) + "(c, begin);\n"
+					"\t\t\tif (cebnf::Tree::Failed(res)) return " + eps + ";\n"
+					"\t\t\treturn res;\n");
+				function(name + "_match", false,
+					"\t\t\tconst std::size_t len = " + call(e.children[0], false) + "(c, begin);\n"
+					"\t\t\treturn len == cebnf::no_match ? 0 : len;\n");
+				break;
+			case GrammarExpr::rep: {
+				if (e.max == 0) {
+					function(name + "_parse", true, unused + "\t\t\treturn " + eps + ";\n");
+					function(name + "_match", false, unused + "\t\t\treturn 0;\n");
+					break;
+				}
+				const std::string max = u(e.max);
+				const std::string min = u(e.min);
+				function(name + "_parse", true,
+					"\t\t\tcebnf::SyntaxTree res = " + call(e.children[0], true) + "(c, begin);\n"
+					"\t\t\tif (cebnf::Tree::Failed(res)) return " + (e.min == 0 ? eps : fail) + ";\n\n"
+					"\t\t\tunsigned int count = 1;\n"
+					"\t\t\twhile (count < " + max + ") {\n"
+					"\t\t\t\tconst std::size_t pos = skip(c, begin + res.second);\n"
+					"\t\t\t\tcebnf::SyntaxTree x = " + call(e.children[0], true) + "(c, pos);\n"
+					"\t\t\t\tif (cebnf::Tree::Failed(x)) break;\n"
+					"\t\t\t\tif (x.second > 0) res.second = pos - begin;\n"
+					"\t\t\t\tcebnf::Tree::Merge(res, std::move(x));\n"
+					"\t\t\t\tcount++;\n"
+					"\t\t\t}\n"
+					+ (e.min > 1 ? "\t\t\tif (count < " + min + ") return " + fail + ";\n" : "") +
+					"\t\t\treturn res;\n");
+				function(name + "_match", false,
+					"\t\t\tstd::size_t len = " + call(e.children[0], false) + "(c, begin);\n"
+					"\t\t\tif (len == cebnf::no_match) return " + (e.min == 0 ? "0" : "cebnf::no_match") + ";\n\n"
+					"\t\t\tunsigned int count = 1;\n"
+					"\t\t\twhile (count < " + max + ") {\n"
+					"\t\t\t\tconst std::size_t pos = skip(c, begin + len);\n"
+					"\t\t\t\tconst std::size_t x = " + call(e.children[0], false) + "(c, pos);\n"
+					"\t\t\t\tif (x == cebnf::no_match) break;\n"
+					"\t\t\t\tif (x > 0) len = pos - begin + x;\n"
+					"\t\t\t\tcount++;\n"
+					"\t\t\t}\n"
+					+ (e.min > 1 ? "\t\t\treturn count < " + min + " ? cebnf::no_match : len;\n" : "\t\t\treturn len;\n"));
+				break;
+			}
+			case GrammarExpr::mul: {
+				/*n == 0 consumes nothing (same as Mul)*/
+				if (e.min == 0) {
+					function(name + "_parse", true, unused + "\t\t\treturn " + eps + ";\n");
+					function(name + "_match", false, unused + "\t\t\treturn 0;\n");
+					break;
+				}
+				const std::string n = u(e.min);
+				std::string p = "\t\t\tcebnf::SyntaxTree res = " + call(e.children[0], true) + "(c, begin);\n"
+					"\t\t\tif (cebnf::Tree::Failed(res)) return " + fail + ";\n";
+				if (e.min > 1) {
+					p += "\n"
+						"\t\t\tfor (unsigned int i = 1; i < " + n + "; ++i) {\n"
+						"\t\t\t\tconst std::size_t pos = skip(c, begin + res.second);\n"
+						"\t\t\t\tcebnf::SyntaxTree x = " + call(e.children[0], true) + "(c, pos);\n"
+						"\t\t\t\tif (cebnf::Tree::Failed(x)) return " + fail + ";\n"
+						"\t\t\t\tif (x.second > 0) res.second = pos - begin;\n"
+						"\t\t\t\tcebnf::Tree::Merge(res, std::move(x));\n"
+						"\t\t\t}\n";
+				}
+				function(name + "_parse", true, p + "\t\t\treturn res;\n");
+				function(name + "_match", false,
+					"\t\t\tstd::size_t len = 0;\n"
+					"\t\t\tfor (unsigned int i = 0; i < " + n + "; ++i) {\n"
+					"\t\t\t\tconst std::size_t pos = i == 0 ? begin : skip(c, begin + len);\n"
+					"\t\t\t\tconst std::size_t x = " + call(e.children[0], false) + "(c, pos);\n"
+					"\t\t\t\tif (x == cebnf::no_match) return cebnf::no_match;\n"
+					"\t\t\t\tif (x > 0) len = pos - begin + x;\n"
+					"\t\t\t}\n"
+					"\t\t\treturn len;\n");
+				break;
+			}
+			case GrammarExpr::lexeme:
+				function(name + "_parse", true,
+					"\t\t\tconst std::size_t len = " + call(e.children[0], false) + "(noSkip(c), begin);\n"
+					"\t\t\tif (len == cebnf::no_match) return " + fail + ";\n"
+					"\t\t\tif (len == 0) return " + eps + ";\n"
+					"\t\t\treturn cebnf::Tree::Create(" + u(e.token_id) + ", c.str->substr(begin, len), len, begin);\n");
+				function(name + "_match", false,
+					"\t\t\treturn " + call(e.children[0], false) + "(noSkip(c), begin);\n");
+				break;
+			case GrammarExpr::drop:
+				function(name + "_parse", true,
+					"\t\t\tconst std::size_t len = " + call(e.children[0], false) + "(c, begin);\n"
+					"\t\t\tif (len == cebnf::no_match) return " + fail + ";\n"
+					"\t\t\treturn cebnf::Tree::Empty(len);\n");
+				function(name + "_match", false,
+					"\t\t\treturn " + call(e.children[0], false) + "(c, begin);\n");
+				break;
+			default:
+				break;
+			}
+			return true;
+		}
+
+		/*longest match, ties to the first alternative (same as nested Or).
+		only the alternatives whose FIRST set has the input byte (or that match the empty string) are tried*/
+		void emitAlt(const std::string& name, const GrammarExpr& e) {
+			const std::size_t n = e.children.size();
+
+			/*byte -> alternatives to try*/
+			std::vector<std::vector<std::size_t>> viable(256);
+			for (std::size_t i = 0; i < n; ++i) {
+				const GrammarInfo::ByteSet f = _info.first(e.children[i]);
+				const bool nullable = _info.nullable(e.children[i]);
+				for (std::size_t b = 0; b < 256; ++b) {
+					if (nullable || f.test(b)) viable[b].push_back(i);
+				}
+			}
+
+			/*groups of bytes with the same alternatives, the largest one is the default*/
+			std::map<std::vector<std::size_t>, std::vector<std::size_t>> groups;
+			for (std::size_t b = 0; b < 256; ++b) groups[viable[b]].push_back(b);
+			auto def = groups.begin();
+			for (auto itr = groups.begin(); itr != groups.end(); ++itr) {
+				if (itr->second.size() > def->second.size()) def = itr;
+			}
+
+			/*res is needed only if a byte has several alternatives*/
+			bool several = false;
+			for (const auto& g : groups) several = several || g.first.size() > 1;
+
+			std::string p = several ? "\t\t\tcebnf::SyntaxTree res = cebnf::Tree::Create();\n" : "";
+			std::string m = several ? "\t\t\tstd::size_t res = cebnf::no_match;\n" : "";
+			p += "\t\t\tswitch (static_cast<unsigned char>(c.p[begin])) {\n";
+			m += "\t\t\tswitch (static_cast<unsigned char>(c.p[begin])) {\n";
+			auto tries = [&](const std::vector<std::size_t>& alts) {
+				if (alts.empty()) {
+					p += "\t\t\t\treturn cebnf::Tree::Create();\n";
+					m += "\t\t\t\treturn cebnf::no_match;\n";
+					return;
+				}
+				if (alts.size() == 1) {
+					p += "\t\t\t\treturn " + call(e.children[alts[0]], true) + "(c, begin);\n";
+					m += "\t\t\t\treturn " + call(e.children[alts[0]], false) + "(c, begin);\n";
+					return;
+				}
+				for (const std::size_t i : alts) {
+					p += "\t\t\t\t{\n"
+						"\t\t\t\t\tcebnf::SyntaxTree x = " + call(e.children[i], true) + "(c, begin);\n"
+						"\t\t\t\t\tif (!cebnf::Tree::Failed(x) && (cebnf::Tree::Failed(res) || x.second > res.second)) res = std::move(x);\n"
+						"\t\t\t\t}\n";
+					m += "\t\t\t\t{\n"
+						"\t\t\t\t\tconst std::size_t x = " + call(e.children[i], false) + "(c, begin);\n"
+						"\t\t\t\t\tif (x != cebnf::no_match && (res == cebnf::no_match || x > res)) res = x;\n"
+						"\t\t\t\t}\n";
+				}
+				p += "\t\t\t\tbreak;\n";
+				m += "\t\t\t\tbreak;\n";
+			};
+			for (auto itr = groups.begin(); itr != groups.end(); ++itr) {
+				if (itr == def) continue;
+				std::string cases = "\t\t\t";
+				for (const std::size_t b : itr->second) cases += (cases.size() > 3 ? " case " : "case ") + byteLiteral(b) + ":";
+				p += cases + "\n";
+				m += cases + "\n";
+				tries(itr->first);
+			}
+			p += "\t\t\tdefault:\n";
+			m += "\t\t\tdefault:\n";
+			tries(def->first);
+			p += std::string("\t\t\t}\n") + (several ? "\t\t\treturn res;\n" : "");
+			m += std::string("\t\t\t}\n") + (several ? "\t\t\treturn res;\n" : "");
+
+			function(name + "_parse", true, p);
+			function(name + "_match", false, m);
+		}
+
+		GrammarInfo _info;
+		CodeGenOptions _options;
+		std::string _error;
+
+		std::map<const GrammarExpr*, std::size_t> _ids;
+		std::map<std::pair<std::string, std::size_t>, std::string> _prims;
+		std::string _decls;
+		std::string _defs;
+		std::string _prim_defs;
+	};
+
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+
+#include "cebnf.hpp"
+
+#include <deque>
+#include <functional>
+#include <unordered_map>
+
+/*hash-consed syntax tree (DAG)
+
+SyntaxDag::add(tree) interns every subtree: identical subtrees (same token id, same string, same children) are one DagNode.
+- memory grows with the number of distinct fragments, not with the input size
+  (add(std::move(tree)) frees the nodes of the tree while they are interned; for logs, parse and add line by line)
+- DagNode::getID() is dense (0, 1, ... in the order of creation): results per shared node are cached by id (DagCache)
+- source positions are not kept: a shared node stands for every occurrence (getCount)
+- lazy nodes are interned as they are (expand() them first for their children)
+
+example (node count of each distinct subtree, computed once per DagNode):
+	SyntaxDag dag;
+	for (const auto& line : lines) roots.push_back(dag.add(rule.parse(line)));
+	DagCache<std::size_t> nodes;
+	std::function<std::size_t(const DagNode*)> f = [&](const DagNode* n) {
+		std::size_t k = 1;
+		for (const DagNode* c : n->getChildren()) k += nodes.value(c, f);
+		return k;
+	};
+	nodes.value(roots[0], f);
+*/
+namespace cebnf {
+
+	class DagNode {
+		friend class SyntaxDag;
+	public:
+		std::size_t getTokenID() const { return _token_id; }
+		const std::string& getString() const { return _s; }
+		const std::vector<const DagNode*>& getChildren() const { return _children; }
+
+		/*index in the SyntaxDag (SyntaxDag::node(id))*/
+		std::size_t getID() const { return _id; }
+		/*occurrences added to the SyntaxDag (as a tree root or a child)*/
+		std::size_t getCount() const { return _count; }
+
+		/*numeric value of the token (SyntaxNode::hasValue)*/
+		bool hasValue() const { return _value_type != value_none; }
+		bool isInteger() const { return _value_type == value_integer; }
+		bool isReal() const { return _value_type == value_real; }
+		std::int64_t getInteger() const { return _value_type == value_integer ? _integer : 0; }
+		double getReal() const { return _value_type == value_integer ? static_cast<double>(_integer) : _real; }
+
+	private:
+		std::size_t _token_id = 0;
+		std::string _s;
+		std::vector<const DagNode*> _children;
+		std::size_t _id = 0;
+		std::size_t _count = 0;
+
+		enum : unsigned char { value_none, value_integer, value_real } _value_type = value_none;
+		std::int64_t _integer = 0;
+		double _real = 0.0;
+	};
+
+	class SyntaxDag {
+	public:
+		/*intern tree (nullptr: nullptr). the root is shared with identical subtrees added before*/
+		const DagNode* add(const std::unique_ptr<SyntaxNode>& tree) {
+			return tree ? addTree(tree.get(), false) : nullptr;
+		}
+
+		/*same, the nodes of the tree are freed as soon as their parent is interned*/
+		const DagNode* add(std::unique_ptr<SyntaxNode>&& tree) {
+			if (!tree) return nullptr;
+			const DagNode* root = addTree(tree.get(), true);
+			tree.reset();
+			return root;
+		}
+
+		/*distinct subtrees*/
+		std::size_t size() const { return _nodes.size(); }
+		/*nodes of all added trees*/
+		std::size_t occurrences() const { return _occurrences; }
+
+		const DagNode& node(std::size_t id) const { return _nodes[id]; }
+
+		/*bytes of the nodes and their strings / child lists (index excluded)*/
+		std::size_t memorySize() const {
+			std::size_t n = 0;
+			for (const auto& d : _nodes) {
+				n += sizeof(DagNode) + d._children.capacity() * sizeof(const DagNode*);
+				if (d._s.capacity() > std::string().capacity()) n += d._s.capacity() + 1;
+			}
+			return n;
+		}
+
+	private:
+		/*post order (explicit stack, trees can be deep)*/
+		const DagNode* addTree(SyntaxNode* root, bool release) {
+			std::vector<std::pair<SyntaxNode*, std::size_t>> stack; /*node, next child*/
+			std::vector<const DagNode*> done;                       /*interned children of the nodes on the stack*/
+			stack.emplace_back(root, 0);
+			while (!stack.empty()) {
+				SyntaxNode* node = stack.back().first;
+				const std::size_t i = stack.back().second++;
+				if (i < node->children.size()) {
+					stack.emplace_back(node->children[i].get(), 0);
+					continue;
+				}
+				stack.pop_back();
+
+				const std::size_t n = node->children.size();
+				std::vector<const DagNode*> children(done.end() - n, done.end());
+				done.resize(done.size() - n);
+				done.push_back(intern(*node, std::move(children)));
+				if (release) node->children.clear();
+			}
+			return done.back();
+		}
+
+		const DagNode* intern(const SyntaxNode& node, std::vector<const DagNode*>&& children) {
+			++_occurrences;
+
+			std::size_t h = std::hash<std::string>()(node.getString()) ^ (node.getTokenID() * 0x9E3779B97F4A7C15ull);
+			for (const DagNode* c : children) h = (h ^ c->_id) * 0x100000001B3ull;
+
+			const auto range = _index.equal_range(h);
+			for (auto itr = range.first; itr != range.second; ++itr) {
+				DagNode& d = _nodes[itr->second];
+				if (d._token_id == node.getTokenID() && d._children == children && d._s == node.getString()) {
+					++d._count;
+					return &d;
+				}
+			}
+
+			_nodes.emplace_back();
+			DagNode& d = _nodes.back();
+			d._token_id = node.getTokenID();
+			d._s = node.getString();
+			d._children = std::move(children);
+			d._id = _nodes.size() - 1;
+			d._count = 1;
+			if (node.isInteger()) {
+				d._value_type = DagNode::value_integer;
+				d._integer = node.getInteger();
+			}
+			else if (node.isReal()) {
+				d._value_type = DagNode::value_real;
+				d._real = node.getReal();
+			}
+			_index.emplace(h, d._id);
+			return &d;
+		}
+
+		std::deque<DagNode> _nodes; /*stable addresses*/
+		std::unordered_multimap<std::size_t, std::size_t> _index; /*hash -> id*/
+		std::size_t _occurrences = 0;
+	};
+
+	/*result per shared node: value(node, f) calls f(node) once per DagNode (by id), f may call value for the children.
+	V: default constructible. references stay valid while values are added.*/
+	template<class V>
+	class DagCache {
+	public:
+		template<class F>
+		const V& value(const DagNode* node, F&& f) {
+			const std::size_t id = node->getID();
+			if (id < _done.size() && _done[id]) return _values[id];
+
+			V v = f(node);
+			if (id >= _done.size()) {
+				_done.resize(id + 1, false);
+				_values.resize(id + 1);
+			}
+			_values[id] = std::move(v);
+			_done[id] = true;
+			return _values[id];
+		}
+
+		bool has(const DagNode* node) const { return node->getID() < _done.size() && _done[node->getID()]; }
+
+		void clear() {
+			_values.clear();
+			_done.clear();
+		}
+
+	private:
+		std::deque<V> _values;
+		std::vector<bool> _done;
+	};
+
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+
+#include "cebnf.hpp"
+#include "cebnf_simd.hpp"
+
+/*parse error reports
+
+CEBNF::parse(s, error) fills a ParseError (farthest failure position and the expected terminals) in the same parse.
+the line index is built only when an error is reported:
+	cebnf::ParseError error;
+	auto tree = rule.parse(text, error);
+	if (!tree) std::cerr << cebnf::errorMessage(error, cebnf::LineIndex(text)) << "\n"; // 3:14: expected "," or "}"
+*/
+namespace cebnf {
+
+	/*1-based line, 1-based column in bytes*/
+	struct SourceLocation {
+		std::size_t line;
+		std::size_t column;
+	};
+
+	/*offsets of the newlines of a text (16/32 bytes at a time), position -> line and column by binary search*/
+	class LineIndex {
+	public:
+		LineIndex(const char* p, std::size_t n) { add(p, n); }
+		explicit LineIndex(const std::string& s) { add(s.data(), s.size()); }
+		explicit LineIndex(const InputSegments& segs) {
+			for (const auto& piece : segs.pieces()) add(piece.p, piece.n);
+		}
+
+		SourceLocation locate(std::size_t pos) const {
+			const std::size_t line = static_cast<std::size_t>(std::lower_bound(_newlines.begin(), _newlines.end(), pos) - _newlines.begin());
+			return SourceLocation{ line + 1, pos - lineBegin(line + 1) + 1 };
+		}
+
+		std::size_t lines() const { return _newlines.size() + 1; }
+
+		/*offset of the first byte of line (1-based)*/
+		std::size_t lineBegin(std::size_t line) const {
+			return line <= 1 ? 0 : _newlines[line - 2] + 1;
+		}
+
+		/*offset of the newline that ends line (or the size of the text)*/
+		std::size_t lineEnd(std::size_t line) const {
+			return line - 1 < _newlines.size() ? _newlines[line - 1] : _size;
+		}
+
+	private:
+		void add(const char* p, std::size_t n) {
+			simd::findAll(p, n, '\n', _size, _newlines);
+			_size += n;
+		}
+
+		std::vector<std::size_t> _newlines;
+		std::size_t _size = 0;
+	};
+
+	namespace diagnostic_detail {
+		/*in_class: ] - ^ are escaped (byte class), otherwise " (string)*/
+		inline std::string byteLiteral(unsigned char c, bool in_class) {
+			static const char hex[] = "0123456789ABCDEF";
+			switch (c) {
+			case '\t': return "\\t";
+			case '\n': return "\\n";
+			case '\r': return "\\r";
+			case '\\': return "\\\\";
+			case '"': return in_class ? "\"" : "\\\"";
+			case ']': case '-': case '^': return in_class ? std::string("\\") + static_cast<char>(c) : std::string(1, static_cast<char>(c));
+			default:
+				if (c >= 0x20 && c < 0x7F) return std::string(1, static_cast<char>(c));
+				return std::string("\\x") + hex[c >> 4] + hex[c & 15];
+			}
+		}
+
+		/*[a-z0-9_]*/
+		inline std::string byteClass(const std::array<std::uint64_t, 4>& bits) {
+			auto has = [&bits](std::size_t c) { return c < 256 && ((bits[c >> 6] >> (c & 63)) & 1) != 0; };
+			std::string res = "[";
+			for (std::size_t c = 0; c < 256;) {
+				if (!has(c)) {
+					++c;
+					continue;
+				}
+				std::size_t e = c;
+				while (has(e + 1)) ++e;
+				res += byteLiteral(static_cast<unsigned char>(c), true);
+				if (e > c) res += (e == c + 1 ? "" : "-") + byteLiteral(static_cast<unsigned char>(e), true);
+				c = e + 1;
+			}
+			return res + "]";
+		}
+	}
+
+	/*a terminal as it is written in the grammar: "text", Number(), Span([ \t]), ... (nullptr: end of input)*/
+	inline std::string expectedName(const CEBNFBase* e) {
+		if (e == nullptr) {
+			return "end of input";
+		}
+
+		GrammarExpr g;
+		e->describe(g);
+		if (g.kind == GrammarExpr::term) {
+			std::string res = "\"";
+			for (const char c : g.text) res += diagnostic_detail::byteLiteral(static_cast<unsigned char>(c), false);
+			return res + "\"";
+		}
+		if (g.kind != GrammarExpr::primitive) {
+			return "token";
+		}
+
+		/*constructor text without the namespace, byte sets as classes*/
+		std::string res = g.text;
+		const std::string bits = "std::array<std::uint64_t, 4>{ {";
+		const std::size_t b = res.find(bits);
+		if (b != std::string::npos) {
+			const std::size_t e = res.find("} }", b);
+			if (e != std::string::npos) res.replace(b, e + 3 - b, diagnostic_detail::byteClass(g.first));
+		}
+		for (std::size_t i = res.find("cebnf::"); i != std::string::npos; i = res.find("cebnf::", i)) res.erase(i, 7);
+		return res;
+	}
+
+	/*"line:column: expected a, b or c"*/
+	inline std::string errorMessage(const ParseError& error, const LineIndex& lines) {
+		const SourceLocation at = lines.locate(error.position);
+		std::string res = std::to_string(at.line) + ":" + std::to_string(at.column) + ": expected ";
+		if (error.expected.empty()) {
+			return res + "a valid input";
+		}
+		for (std::size_t i = 0; i < error.expected.size(); ++i) {
+			if (i > 0) res += i + 1 == error.expected.size() ? " or " : ", ";
+			res += expectedName(error.expected[i]);
+		}
+		return res;
+	}
+
+}
@@ -0,0 +1,444 @@
+#pragma once
+
+
+#include "cebnf.hpp"
+#include "cebnf_helper.hpp"
+#include "cebnf_diagnostic.hpp"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/*grammars loaded from ISO EBNF text at run time (ISO/IEC 14977 without exception and special sequences)
+
+	name = alternatives ;                 rule (";" or "." ends it, names may contain spaces: digit excluding zero)
+	a , b    a | b    [ a ]    { a }    ( a )    3 * a    "text" or 'text'    (* comment *)
+
+EbnfGrammar::load(text, options) creates one Rule per name and builds its definition from the expressions of a compiled
+grammar (Term, May, Rep, Mul, Drop, Lexeme, and n-ary To / Or: EbnfSeq, EbnfAlt), so the syntax trees are the same,
+| is the longest match, and skipper, tree shape, lazy rules, diagnostics, Searcher and CodeGenerator work on the loaded rules.
+- token ids: options.token_ids by name, the other rules get first_token_id, first_token_id + 1, ... in text order
+- names that are not defined in the text are bound expressions: options.bind("string", StringIE2('"', '"'))
+- options.lexemes: rules matched as one token (no skipper inside, no inner nodes), options.skipper: rule or binding skipped
+  between the elements of every rule, options.drop_terminals: terminals create no node (punctuation)
+
+example:
+	cebnf::EbnfOptions options;
+	options.bind("string", cebnf::StringIE2('"', '"')).bind("space", cebnf::Span(cebnf::CharSet(" \t\r\n")));
+	options.skipper = "space";
+	cebnf::EbnfGrammar grammar;
+	if (!grammar.load("list = \"[\" , [ string , { \",\" , string } ] , \"]\" ;", options)) std::cerr << grammar.error() << "\n";
+	auto tree = grammar.rule("list")->parse(text);
+*/
+namespace cebnf {
+
+	/*child of a loaded expression: a rule, a binding or an expression owned by the EbnfGrammar.
+	a terminal that does not match is reported to the diagnostics as Child does for the terminals of a compiled grammar*/
+	struct EbnfRef final : public CEBNFBase, tagOperator {
+
+		const CEBNFBase* _e = nullptr;
+		bool _terminal = false;
+
+		EbnfRef() {}
+		EbnfRef(const CEBNFBase* e, bool terminal) : _e(e), _terminal(terminal) {}
+
+
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			SyntaxTree tree = _e->parse_impl(s, begin);
+			if (_terminal && Tree::Failed(tree)) s.fail(begin, _e);
+			return tree;
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			const std::size_t len = _e->match_impl(s, begin);
+			if (_terminal && len == no_match) s.fail(begin, _e);
+			return len;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			_e->describe(e);
+		}
+	};
+
+	/*a , b , c: the lengths and nodes of To<To<a, b>, c> with one call per element*/
+	struct EbnfSeq final : public CEBNFBase, tagOperator {
+
+		std::vector<EbnfRef> _items;
+
+		EbnfSeq(std::vector<EbnfRef> items) : _items(std::move(items)) {}
+
+
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			SyntaxTree&& children = Child::parse(_items[0], s, begin);
+			if (Tree::Failed(children)) {
+				return Tree::Create();
+			}
+
+			for (std::size_t i = 1; i < _items.size(); ++i) {
+				const std::size_t posX = s.skip(begin + children.second);
+				SyntaxTree&& childrenX = Child::parse(_items[i], s, posX);
+				if (Tree::Failed(childrenX)) {
+					return Tree::Create();
+				}
+				if (childrenX.second > 0) {
+					children.second = posX - begin;
+				}
+				Tree::Merge(children, std::move(childrenX));
+			}
+			return std::move(children);
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			std::size_t len = Child::match(_items[0], s, begin);
+			if (len == no_match) {
+				return no_match;
+			}
+
+			for (std::size_t i = 1; i < _items.size(); ++i) {
+				const std::size_t posX = s.skip(begin + len);
+				const std::size_t lenX = Child::match(_items[i], s, posX);
+				if (lenX == no_match) {
+					return no_match;
+				}
+				if (lenX > 0) {
+					len = posX - begin + lenX;
+				}
+			}
+			return len;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			e.kind = GrammarExpr::seq;
+			for (const auto& item : _items) {
+				GrammarExpr c;
+				item.describe(c);
+				e.add(std::move(c));
+			}
+		}
+	};
+
+	/*a | b | c: the longest match, the first one of the same length (Or<Or<a, b>, c>)*/
+	struct EbnfAlt final : public CEBNFBase, tagOperator {
+
+		std::vector<EbnfRef> _items;
+
+		EbnfAlt(std::vector<EbnfRef> items) : _items(std::move(items)) {}
+
+
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			SyntaxTree res = Tree::Create();
+			for (const auto& item : _items) {
+				SyntaxTree&& children = Child::parse(item, s, begin);
+				if (!Tree::Failed(children) && (Tree::Failed(res) || children.second > res.second)) {
+					res = std::move(children);
+				}
+			}
+			return res;
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			std::size_t res = no_match;
+			for (const auto& item : _items) {
+				const std::size_t len = Child::match(item, s, begin);
+				if (len != no_match && (res == no_match || len > res)) {
+					res = len;
+				}
+			}
+			return res;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			e.kind = GrammarExpr::alt;
+			for (const auto& item : _items) {
+				GrammarExpr c;
+				item.describe(c);
+				e.add(std::move(c));
+			}
+		}
+	};
+
+	struct EbnfOptions {
+		struct Binding {
+			std::shared_ptr<const CEBNFBase> expr;
+			bool terminal;
+			void (*assign)(Rule& rule, const CEBNFBase& expr, bool skipper);  /*rule = expr or rule.setSkipper(expr) with a copy of the type of expr*/
+		};
+
+		std::map<std::string, std::size_t> token_ids;  /*token id of a rule by name*/
+		std::size_t first_token_id = 0;                /*token id of the first rule that is not in token_ids*/
+		std::map<std::string, Binding> bindings;       /*expressions of the names that are not defined in the text*/
+		std::set<std::string> lexemes;                 /*rules matched as one token*/
+		std::string skipper;                           /*rule or binding skipped by every rule ("": none)*/
+		bool drop_terminals = false;                   /*terminals match without a node*/
+
+		/*name -> copy of the expression e (Number(), StringIE2('"', '"'), +compiled_rule, ...)*/
+		template<typename CEBNF_EQ, CEBNFBase_is_base_of_t<CEBNF_EQ> = nullptr>
+		EbnfOptions& bind(const std::string& name, CEBNF_EQ const& e) {
+			bindings[name] = Binding{ std::make_shared<CEBNF_EQ>(e), IsTerminal<CEBNF_EQ>::value,
+				[](Rule& rule, const CEBNFBase& expr, bool skipper) {
+					if (skipper) rule.setSkipper(static_cast<CEBNF_EQ const&>(expr));
+					else rule = static_cast<CEBNF_EQ const&>(expr);
+				} };
+			return *this;
+		}
+
+		/*helper token without a name (GrammarImage::load matches every binding by its C++ expression and token id)*/
+		template<typename CEBNF_EQ, CEBNFBase_is_base_of_t<CEBNF_EQ> = nullptr>
+		EbnfOptions& bind(CEBNF_EQ const& e) {
+			GrammarExpr g;
+			e.describe(g);
+			return bind(g.text + "#" + std::to_string(g.token_id), e);
+		}
+	};
+
+	/*ISO EBNF syntax (built once, SharedGrammar)*/
+	struct EbnfSyntax {
+		enum ebnf_token {
+			ebnf_syntax,
+			ebnf_rule,
+			ebnf_name,
+			ebnf_word,
+			ebnf_alternatives,
+			ebnf_sequence,
+			ebnf_factor,
+			ebnf_count,
+			ebnf_optional,
+			ebnf_repeated,
+			ebnf_group,
+			ebnf_terminal,
+		};
+
+		CEBNF<ebnf_syntax		> _syntax;
+		CEBNF<ebnf_rule			> _rule;
+		CEBNF<ebnf_name			> _name;
+		CEBNF<ebnf_alternatives	> _alternatives;
+		CEBNF<ebnf_sequence		> _sequence;
+		CEBNF<ebnf_factor		> _factor;
+		CEBNF<ebnf_count		> _count;
+		CEBNF<ebnf_optional		> _optional;
+		CEBNF<ebnf_repeated		> _repeated;
+		CEBNF<ebnf_group		> _group;
+		CEBNF<ebnf_terminal		> _terminal;
+
+		EbnfSyntax() {
+			CEBNF_OperatorTools t;
+
+			auto word = [&t]() { return t.lexeme(CharSet("A-Za-z") - t[Span(CharSet("A-Za-z0-9_"))], ebnf_word); };
+			auto quoted = [&t](const char* q) { return t.lexeme(Term(q) - Span(CharSet(q).invert()) - Term(q)); };
+			/*(* ... *): runs without '*', or runs of '*' before another byte than ')'*/
+			auto comment = [&t]() { return t.lexeme(Term("(*") - t({ Span(CharSet("*").invert()) | (Span(CharSet("*")) - CharSet("*)").invert()) }) - Span(CharSet("*")) - Term(")")); };
+
+			_name           = word() - t(word());
+			_terminal       = quoted("\"") | quoted("'");
+			_count          = Span(CharSet("0-9"));
+			_optional       = t.drop(Term("[")) - _alternatives - t.drop(Term("]"));
+			_repeated       = t.drop(Term("{")) - _alternatives - t.drop(Term("}"));
+			_group          = t.drop(Term("(")) - _alternatives - t.drop(Term(")"));
+			_factor         = t[_count - t.drop(Term("*"))] - (_optional | _repeated | _group | _terminal | _name);
+			_sequence       = _factor - t({ t.drop(Term(",")) - _factor });
+			_alternatives   = _sequence - t({ t.drop(Term("|")) - _sequence });
+			_rule           = _name - t.drop(Term("=")) - _alternatives - t.drop(Term(";") | Term("."));
+			_syntax         = _rule - t({ +_rule });
+
+			_syntax.setSkipper(Span(CharSet(" \t\r\n")) | comment());
+		}
+	};
+
+	/*rules loaded from EBNF text. rules are referenced by address: movable, not copyable*/
+	class EbnfGrammar {
+	public:
+		/*false: error() is "line:column: message" (the previous rules are removed in any case)*/
+		bool load(const std::string& text, const EbnfOptions& options = EbnfOptions()) {
+			_rules.clear();
+			_names.clear();
+			_index.clear();
+			_exprs.clear();
+			_bound.clear();
+			_error.clear();
+
+			ParseError error;
+			const std::unique_ptr<SyntaxNode> tree = SharedGrammar<EbnfSyntax>::get()->_syntax.parse(text, error);
+			if (tree == nullptr) {
+				_error = errorMessage(error, LineIndex(text));
+				return false;
+			}
+
+			/*rules first: definitions refer to rules defined later*/
+			std::size_t next_id = options.first_token_id;
+			for (const auto& r : tree->children) {
+				const std::string name = nameOf(*r->children[0]);
+				if (_index.count(name) > 0) {
+					return fail(text, *r, "rule " + name + " is defined twice");
+				}
+				const auto id = options.token_ids.find(name);
+				_index[name] = _rules.size();
+				_names.push_back(name);
+				_rules.emplace_back(new Rule(id != options.token_ids.end() ? id->second : next_id++));
+			}
+
+			for (std::size_t i = 0; i < _rules.size(); ++i) {
+				const SyntaxNode& def = *tree->children[i]->children[1];
+				Rule& rule = *_rules[i];
+				if (options.lexemes.count(_names[i]) > 0) {
+					EbnfRef e;
+					if (!build(text, def, options, nullptr, e)) return false;
+					rule = Lexeme<EbnfRef>(e, cebnf_type::lexeme);
+				}
+				else {
+					EbnfRef e;
+					if (!build(text, def, options, &rule, e)) return false;
+				}
+			}
+
+			if (!options.skipper.empty()) {
+				EbnfRef skipper;
+				if (!lookup(options.skipper, options, skipper)) {
+					_error = "skipper " + options.skipper + " is not defined";
+					return false;
+				}
+				/*a terminal binding is copied, other expressions do not skip inside the skipper*/
+				const auto b = options.bindings.find(options.skipper);
+				for (auto& r : _rules) {
+					if (_index.count(options.skipper) == 0 && b->second.terminal) b->second.assign(*r, *b->second.expr, true);
+					else r->setSkipper(Lexeme<EbnfRef>(skipper, cebnf_type::lexeme));
+				}
+			}
+			return true;
+		}
+
+		const std::string& error() const { return _error; }
+
+		/*rule of the name (nullptr: not defined)*/
+		Rule* rule(const std::string& name) const {
+			const auto itr = _index.find(name);
+			return itr == _index.end() ? nullptr : _rules[itr->second].get();
+		}
+
+		/*rule names in text order (the first is the start rule of the text)*/
+		const std::vector<std::string>& names() const { return _names; }
+
+	private:
+		/*expression of node in e. define: the expression is the definition of this rule (e is the rule)*/
+		bool build(const std::string& text, const SyntaxNode& node, const EbnfOptions& options, Rule* define, EbnfRef& e) {
+			using T = EbnfSyntax;
+			switch (node.getTokenID()) {
+			case T::ebnf_alternatives:
+			case T::ebnf_sequence: {
+				if (node.children.size() == 1) {
+					return build(text, *node.children[0], options, define, e);
+				}
+				std::vector<EbnfRef> items(node.children.size());
+				for (std::size_t i = 0; i < node.children.size(); ++i) {
+					if (!build(text, *node.children[i], options, nullptr, items[i])) return false;
+				}
+				e = node.getTokenID() == T::ebnf_sequence ? store(EbnfSeq(std::move(items)), define) : store(EbnfAlt(std::move(items)), define);
+				return true;
+			}
+			case T::ebnf_factor: {
+				if (node.children.size() == 1) {
+					return build(text, *node.children[0], options, define, e);
+				}
+				const std::string& count = node.children[0]->getString();
+				if (count.size() > 9) {
+					return fail(text, node, "repetition count " + count + " is too large");
+				}
+				if (!build(text, *node.children[1], options, nullptr, e)) return false;
+				const unsigned int n = static_cast<unsigned int>(std::stoul(count));
+				e = store(Mul<EbnfRef>(n, e), define);
+				return true;
+			}
+			case T::ebnf_optional:
+			case T::ebnf_repeated: {
+				if (!build(text, *node.children[0], options, nullptr, e)) return false;
+				e = node.getTokenID() == T::ebnf_optional ? store(May<EbnfRef>(e), define) : store(Rep<EbnfRef>(e), define);
+				return true;
+			}
+			case T::ebnf_group:
+				return build(text, *node.children[0], options, define, e);
+			case T::ebnf_terminal: {
+				const std::string& s = node.getString();
+				if (!options.drop_terminals) {
+					e = store(Term(s.substr(1, s.size() - 2)), define);
+					return true;
+				}
+				e = store(Drop<Term>(Term(s.substr(1, s.size() - 2))), define);
+				return true;
+			}
+			case T::ebnf_name: {
+				const std::string name = nameOf(node);
+				if (!lookup(name, options, e)) {
+					return fail(text, node, name + " is not defined");
+				}
+				if (define == nullptr) {
+					return true;
+				}
+
+				/*name = binding: the rule holds a copy of the expression as in a compiled grammar*/
+				const auto b = options.bindings.find(name);
+				if (_index.count(name) == 0 && b != options.bindings.end()) {
+					b->second.assign(*define, *b->second.expr, false);
+				}
+				else {
+					store(Wrap<EbnfRef>(e), define);
+				}
+				e = EbnfRef{ define, false };
+				return true;
+			}
+			default:
+				return fail(text, node, "unexpected " + node.getString());
+			}
+		}
+
+		/*the expression in _exprs, or the definition of the rule*/
+		template<class E>
+		EbnfRef store(E e, Rule* define) {
+			if (define != nullptr) {
+				*define = e;
+				return EbnfRef{ define, false };
+			}
+			_exprs.emplace_back(new E(std::move(e)));
+			return EbnfRef{ _exprs.back().get(), IsTerminal<E>::value };
+		}
+
+		/*rule of the text or binding*/
+		bool lookup(const std::string& name, const EbnfOptions& options, EbnfRef& e) {
+			const auto r = _index.find(name);
+			if (r != _index.end()) {
+				e = EbnfRef{ _rules[r->second].get(), false };
+				return true;
+			}
+			const auto b = options.bindings.find(name);
+			if (b == options.bindings.end()) {
+				return false;
+			}
+			_bound.push_back(b->second.expr);
+			e = EbnfRef{ b->second.expr.get(), b->second.terminal };
+			return true;
+		}
+
+		/*words of a name joined by one space*/
+		static std::string nameOf(const SyntaxNode& node) {
+			std::string res;
+			for (const auto& w : node.children) {
+				if (!res.empty()) res += ' ';
+				res += w->getString();
+			}
+			return res;
+		}
+
+		bool fail(const std::string& text, const SyntaxNode& node, const std::string& message) {
+			const SourceLocation at = LineIndex(text).locate(node.getBegin());
+			_error = std::to_string(at.line) + ":" + std::to_string(at.column) + ": " + message;
+			return false;
+		}
+
+		std::vector<std::unique_ptr<Rule>> _rules;
+		std::vector<std::string> _names;
+		std::map<std::string, std::size_t> _index;
+		std::vector<std::unique_ptr<CEBNFBase>> _exprs;
+		std::vector<std::shared_ptr<const CEBNFBase>> _bound;
+		std::string _error;
+	};
+
+}
@@ -0,0 +1,316 @@
+#pragma once
+
+
+#include "cebnf.hpp"
+
+#include <bitset>
+#include <map>
+
+/*grammar analysis over GrammarExpr (CEBNFBase::describe)
+
+rules: the rules reachable from the start rule and its skipper (rules[0] is the start)
+first(e): bytes a non-empty match of e can start with, nullable(e): e can match the empty string
+- FIRST of a concatenation includes the skipper bytes after a nullable element (the skipper runs between elements)
+- opaque expressions are "any byte, nullable", so the sets are always a superset (safe for prefilters)
+optimize(): rewrites the definitions for the grammar tools (flatten, inline, left factor) keeping every syntax tree
+*/
+namespace cebnf {
+
+	/*GrammarInfo::optimize passes*/
+	struct OptimizeOptions {
+		bool flatten = true;
+		bool inline_rules = true;
+		bool left_factor = true;
+		std::size_t inline_max_size = 8;  /*expressions in the definition of an inlined rule*/
+	};
+
+	class GrammarInfo {
+	public:
+		using ByteSet = std::bitset<256>;
+
+		struct Rule {
+			const CEBNFBase* ref;
+			std::size_t token_id;
+			GrammarExpr def;
+			bool defined;
+			ByteSet first;
+			bool nullable;
+			tree_shape shape;
+		};
+
+		explicit GrammarInfo(const CEBNFBase& start) {
+			GrammarExpr e;
+			start.describe(e);
+			if (e.kind != GrammarExpr::rule) {
+				/*not a rule: an anonymous rule of the expression*/
+				_rules.push_back(Rule{ &start, 0, std::move(e), true, ByteSet(), false, shape_keep });
+			}
+			else {
+				addRule(e);
+			}
+			_has_skipper = start.describeSkipper(_skipper);
+			if (_has_skipper) collect(_skipper);
+
+			for (std::size_t i = 0; i < _rules.size(); ++i) {
+				const GrammarExpr def = _rules[i].def; /*collect appends to _rules*/
+				collect(def);
+			}
+
+			/*fixpoint: FIRST and nullable only grow*/
+			bool changed = true;
+			while (changed) {
+				changed = false;
+				if (_has_skipper) _skip_first = first(_skipper);
+				for (auto& r : _rules) {
+					const ByteSet f = r.defined ? first(r.def) : ByteSet().set();
+					const bool n = r.defined ? nullable(r.def) : true;
+					if (f != r.first || n != r.nullable) {
+						r.first = f;
+						r.nullable = n;
+						changed = true;
+					}
+				}
+			}
+		}
+
+		/*prepared analysis (GrammarImage::load): rules with the FIRST sets and nullable flags of the constructor above, no fixpoint*/
+		GrammarInfo(std::vector<Rule> rules, bool has_skipper, GrammarExpr skipper, const ByteSet& skipper_first)
+			: _rules(std::move(rules)), _has_skipper(has_skipper), _skipper(std::move(skipper)), _skip_first(skipper_first) {
+			for (std::size_t i = 0; i < _rules.size(); ++i) _index[_rules[i].ref] = i;
+		}
+
+		/*rewrite the rule definitions and the skipper. the syntax tree of every rule, FIRST and nullable do not change.
+		- flatten: seq in seq, alt in alt -> one n-ary seq / alt
+		- inline: references to small non-recursive rules -> node (the rule node is still created, with the shape of the rule)
+		- left factor: adjacent alternatives seq(P, X...) | seq(P, Y...) -> seq(P, alt(seq(X...), seq(Y...))), P is parsed once.
+		  (longest match is kept: after the same P, a longer rest is a longer alternative. ties stay with the first one)*/
+		void optimize(const OptimizeOptions& options = OptimizeOptions()) {
+			std::vector<bool> inlinable(_rules.size(), false);
+			if (options.inline_rules) {
+				/*the start rule stays (it is the entry)*/
+				for (std::size_t k = 1; k < _rules.size(); ++k) {
+					inlinable[k] = _rules[k].defined && _rules[k].def.size() <= options.inline_max_size && !reaches(k, k);
+				}
+			}
+
+			for (auto& r : _rules) {
+				if (r.defined) rewrite(r.def, options, inlinable);
+			}
+			if (_has_skipper) rewrite(_skipper, options, inlinable);
+		}
+
+		const std::vector<Rule>& rules() const { return _rules; }
+		bool hasSkipper() const { return _has_skipper; }
+		const GrammarExpr& skipper() const { return _skipper; }
+		const ByteSet& skipperFirst() const { return _skip_first; }
+
+		/*index in rules() (no_match if the rule is not reachable)*/
+		std::size_t ruleIndex(const CEBNFBase* ref) const {
+			const auto itr = _index.find(ref);
+			return itr == _index.end() ? no_match : itr->second;
+		}
+
+		ByteSet first(const GrammarExpr& e) const {
+			ByteSet res;
+			switch (e.kind) {
+			case GrammarExpr::term:
+				if (!e.text.empty()) res.set(static_cast<unsigned char>(e.text[0]));
+				return res;
+			case GrammarExpr::primitive:
+				for (std::size_t c = 0; c < 256; ++c) {
+					if ((e.first[c >> 6] >> (c & 63)) & 1) res.set(c);
+				}
+				return res;
+			case GrammarExpr::rule:
+				return _rules[ruleIndex(e.ref)].first;
+			case GrammarExpr::seq:
+				for (const auto& c : e.children) {
+					res |= first(c);
+					if (!nullable(c)) break;
+					res |= _skip_first;
+				}
+				return res;
+			case GrammarExpr::alt:
+				for (const auto& c : e.children) res |= first(c);
+				return res;
+			case GrammarExpr::rep:
+			case GrammarExpr::mul:
+				if (e.min == 0) return res;
+				res = first(e.children[0]);
+				if (nullable(e.children[0])) res |= _skip_first;
+				return res;
+			case GrammarExpr::opt:
+			case GrammarExpr::lexeme:
+			case GrammarExpr::drop:
+			case GrammarExpr::pratt:
+			case GrammarExpr::node:
+				return first(e.children[0]);
+			default:
+				return res.set();
+			}
+		}
+
+		bool nullable(const GrammarExpr& e) const {
+			switch (e.kind) {
+			case GrammarExpr::term:
+				return e.text.empty();
+			case GrammarExpr::primitive:
+				return false;
+			case GrammarExpr::rule:
+				return _rules[ruleIndex(e.ref)].nullable;
+			case GrammarExpr::seq:
+				for (const auto& c : e.children) {
+					if (!nullable(c)) return false;
+				}
+				return true;
+			case GrammarExpr::alt:
+				for (const auto& c : e.children) {
+					if (nullable(c)) return true;
+				}
+				return false;
+			case GrammarExpr::opt:
+				return true;
+			case GrammarExpr::rep:
+				return e.min == 0 || e.max == 0 || nullable(e.children[0]);
+			case GrammarExpr::mul:
+				return e.min == 0 || nullable(e.children[0]);
+			case GrammarExpr::lexeme:
+			case GrammarExpr::drop:
+			case GrammarExpr::pratt:
+			case GrammarExpr::node:
+				return nullable(e.children[0]);
+			default:
+				return true;
+			}
+		}
+
+	private:
+		void addRule(const GrammarExpr& e) {
+			if (_index.count(e.ref) > 0) return;
+			_index[e.ref] = _rules.size();
+			GrammarExpr def;
+			const bool defined = e.ref->describeRule(def);
+			_rules.push_back(Rule{ e.ref, e.token_id, std::move(def), defined, ByteSet(), false, e.shape });
+		}
+
+		/*rules referenced by e (appended to _rules, collected by the caller's loop)*/
+		void collect(const GrammarExpr& e) {
+			if (e.kind == GrammarExpr::rule) {
+				addRule(e);
+				return;
+			}
+			for (const auto& c : e.children) collect(c);
+		}
+
+		/*rule `to` is referenced from the definition of `from` (directly or through other rules)*/
+		bool reaches(std::size_t from, std::size_t to) const {
+			std::vector<bool> seen(_rules.size(), false);
+			std::vector<std::size_t> stack(1, from);
+			std::vector<const GrammarExpr*> exprs;
+			while (!stack.empty()) {
+				const std::size_t k = stack.back();
+				stack.pop_back();
+				exprs.assign(1, &_rules[k].def);
+				while (!exprs.empty()) {
+					const GrammarExpr* e = exprs.back();
+					exprs.pop_back();
+					if (e->kind == GrammarExpr::rule) {
+						const std::size_t r = ruleIndex(e->ref);
+						if (r == to) return true;
+						if (!seen[r]) {
+							seen[r] = true;
+							stack.push_back(r);
+						}
+						continue;
+					}
+					for (const auto& c : e->children) exprs.push_back(&c);
+				}
+			}
+			return false;
+		}
+
+		void rewrite(GrammarExpr& e, const OptimizeOptions& options, const std::vector<bool>& inlinable) const {
+			if (e.kind == GrammarExpr::rule) {
+				const std::size_t k = ruleIndex(e.ref);
+				if (!inlinable[k]) return;
+
+				GrammarExpr node;
+				node.kind = GrammarExpr::node;
+				node.token_id = _rules[k].token_id;
+				node.shape = _rules[k].shape;
+				node.children.push_back(_rules[k].def);
+				e = std::move(node);
+			}
+
+			for (auto& c : e.children) rewrite(c, options, inlinable);
+
+			if (options.flatten) flatten(e);
+			if (options.left_factor && e.kind == GrammarExpr::alt) {
+				leftFactor(e);
+				if (options.flatten) flatten(e);
+			}
+		}
+
+		static void flatten(GrammarExpr& e) {
+			if (e.kind != GrammarExpr::seq && e.kind != GrammarExpr::alt) return;
+
+			std::vector<GrammarExpr> children;
+			children.swap(e.children);
+			for (auto& c : children) {
+				flatten(c);
+				e.add(std::move(c));
+			}
+		}
+
+		static void leftFactor(GrammarExpr& e) {
+			auto factorable = [](const GrammarExpr& c) { return c.kind == GrammarExpr::seq && c.children.size() >= 2; };
+
+			std::vector<GrammarExpr> alts;
+			const std::size_t n = e.children.size();
+			for (std::size_t i = 0; i < n;) {
+				std::size_t j = i + 1;
+				if (factorable(e.children[i])) {
+					while (j < n && factorable(e.children[j]) && e.children[j].children[0] == e.children[i].children[0]) ++j;
+				}
+				if (j - i < 2) {
+					alts.push_back(std::move(e.children[i]));
+					i = j;
+					continue;
+				}
+
+				/*seq(P, alt(rest of i, ..., rest of j - 1))*/
+				GrammarExpr rest;
+				rest.kind = GrammarExpr::alt;
+				for (std::size_t k = i; k < j; ++k) {
+					GrammarExpr r;
+					r.kind = GrammarExpr::seq;
+					r.children.assign(std::make_move_iterator(e.children[k].children.begin() + 1), std::make_move_iterator(e.children[k].children.end()));
+					rest.add(r.children.size() == 1 ? std::move(r.children[0]) : std::move(r));
+				}
+				leftFactor(rest);
+
+				GrammarExpr f;
+				f.kind = GrammarExpr::seq;
+				f.children.push_back(std::move(e.children[i].children[0]));
+				f.add(std::move(rest));
+				alts.push_back(std::move(f));
+				i = j;
+			}
+
+			if (alts.size() == 1) {
+				GrammarExpr single = std::move(alts[0]);
+				e = std::move(single);
+			}
+			else {
+				e.children = std::move(alts);
+			}
+		}
+
+		std::vector<Rule> _rules;
+		std::map<const CEBNFBase*, std::size_t> _index;
+		bool _has_skipper = false;
+		GrammarExpr _skipper;
+		ByteSet _skip_first;
+	};
+
+}
@@ -2,6 +2,11 @@
 
 
 #include "cebnf.hpp"
+#include "cebnf_simd.hpp"
+#include "cebnf_unicode.hpp"
+
+#include <charconv>
+#include <limits>
 
 namespace cebnf {
 
@@ -20,6 +25,12 @@ namespace cebnf {
 		string,
 		string_in_enclosure,//not replacement escape sequence series (example: \\\" ->  \\\")
 		string_in_enclosure_2,//replacement escape sequence series (example: \\\" ->  \")
+		char_set,
+		span,//run of CharSet characters as one token
+		unicode_char,
+		unicode_span,//run of UnicodeChar code points as one token
+		number,//Integer or RealNumber with an exponent
+		balanced,//balanced delimiters as one token (lazy span)
 		expand_end
 	};
 
@@ -29,6 +40,7 @@ namespace cebnf {
 	struct NaturalNumber;
 	struct Integer;
 	struct RealNumber;
+	struct Number;
 
 	struct AlphabetS;
 	struct AlphabetL;
@@ -36,8 +48,217 @@ namespace cebnf {
 	struct StringIE;
 	struct StringIE2;
 
+	struct CharSet;
+	struct Span;
+	struct UnicodeChar;
+	struct UnicodeSpan;
+	struct Balanced;
+
 	/*-------------------------------------------------------------------------------*/
 
+	/*grammar tools: description of the helper tokens (GrammarExpr::primitive)*/
+	struct GrammarHelper {
+
+		/*CharSet pattern -> 256-bit bitmap ("x-y" is a range, "-" at the head or the tail is listed)*/
+		static std::array<std::uint64_t, 4> bits(const std::string& pattern) {
+			std::array<std::uint64_t, 4> res = {};
+			for (std::size_t i = 0; i < pattern.size(); ++i) {
+				unsigned int first = static_cast<unsigned char>(pattern[i]);
+				unsigned int last = first;
+				if (i + 2 < pattern.size() && pattern[i + 1] == '-') {
+					last = static_cast<unsigned char>(pattern[i + 2]);
+					i += 2;
+				}
+				for (unsigned int c = first; c <= last; ++c) {
+					res[c >> 6] |= std::uint64_t(1) << (c & 63);
+				}
+			}
+			return res;
+		}
+
+		static std::string charLiteral(const char c) {
+			const char* hex = "0123456789abcdef";
+			const unsigned char u = static_cast<unsigned char>(c);
+			return std::string("'\\x") + hex[u >> 4] + hex[u & 15] + "'";
+		}
+
+		static std::string bitsLiteral(const std::array<std::uint64_t, 4>& bits) {
+			std::string res = "std::array<std::uint64_t, 4>{ { ";
+			for (std::size_t i = 0; i < 4; ++i) {
+				res += (i == 0 ? "" : ", ") + std::to_string(bits[i]) + "ULL";
+			}
+			return res + " } }";
+		}
+
+		static void describe(GrammarExpr& e, std::string ctor, std::size_t token_id, const std::array<std::uint64_t, 4>& first) {
+			e.kind = GrammarExpr::primitive;
+			e.text = std::move(ctor);
+			e.token_id = token_id;
+			e.first = first;
+		}
+	};
+
+	/*-------------------------------------------------------------------------------*/
+
+	/*
+	numeric text scanned once: length and value (no digit string, no second conversion)
+	- integers that fit int64 are accumulated exactly (overflow falls back to double)
+	- doubles: Clinger fast path (<= 19 digits, mantissa <= 2^53, |exponent| <= 22), otherwise std::from_chars; both round correctly
+	*/
+	struct NumberHelper {
+
+		enum form {
+			integer_form,//Integer
+			real_form,//RealNumber
+			number_form//Number
+		};
+
+		struct Scan {
+			std::size_t length = no_match;
+			bool is_integer = false;
+			std::int64_t integer = 0;
+			double real = 0.0;
+		};
+
+		/*with_value = false: length only (match mode)*/
+		static Scan scan(const Input& s, const std::size_t begin, const form f, const bool with_value = true) {
+			Scan res;
+			std::size_t itr = begin;
+
+			bool negative = false;
+			if (s[itr] == '+' || s[itr] == '-') {
+				negative = s[itr] == '-';
+				itr++;
+			}
+
+			/*mantissa: up to 19 significant digits, value = w * 10^exp10*/
+			std::uint64_t w = 0;
+			int digits = 0;
+			int exp10 = 0;
+			bool truncated = false;
+			auto digit = [&](const char c, const bool fraction) {
+				if (digits < 19) {
+					w = w * 10 + static_cast<std::uint64_t>(c - '0');
+					if (w != 0) digits++;
+					if (fraction) exp10--;
+				}
+				else {
+					truncated = true;
+					if (!fraction) exp10++;
+				}
+			};
+
+			bool integer_area = false;
+			if (s[itr] == '0') {
+				itr++;
+				integer_area = true;
+			}
+			else if ('1' <= s[itr] && s[itr] <= '9') {
+				while ('0' <= s[itr] && s[itr] <= '9') {
+					digit(s[itr++], false);
+				}
+				integer_area = true;
+			}
+
+			bool real = false;
+			if (f != integer_form && s[itr] == '.') {
+				std::size_t fraction = itr + 1;
+				while ('0' <= s[fraction] && s[fraction] <= '9') {
+					digit(s[fraction++], true);
+				}
+				if (integer_area || fraction > itr + 1) {
+					itr = fraction;
+					real = true;
+				}
+			}
+
+			if (!integer_area && !real) {
+				return res;
+			}
+			if (f == real_form && !real) {
+				return res;
+			}
+
+			/*exponent :: ( "E" | "e" ) , Integer*/
+			if (f == number_form && (s[itr] == 'E' || s[itr] == 'e')) {
+				std::size_t e = itr + 1;
+				bool exp_negative = false;
+				if (s[e] == '+' || s[e] == '-') {
+					exp_negative = s[e] == '-';
+					e++;
+				}
+
+				int exp_value = 0;
+				bool exp_exists = false;
+				if (s[e] == '0') {
+					e++;
+					exp_exists = true;
+				}
+				else if ('1' <= s[e] && s[e] <= '9') {
+					while ('0' <= s[e] && s[e] <= '9') {
+						if (exp_value < 100000) exp_value = exp_value * 10 + (s[e] - '0');
+						e++;
+					}
+					exp_exists = true;
+				}
+
+				if (exp_exists) {
+					itr = e;
+					exp10 += exp_negative ? -exp_value : exp_value;
+					real = true;
+				}
+			}
+
+			res.length = itr - begin;
+			if (!with_value) {
+				return res;
+			}
+
+			/*integer*/
+			const std::uint64_t int64_limit = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+			if (!real && !truncated && w <= int64_limit + (negative ? 1 : 0)) {
+				res.is_integer = true;
+				res.integer = negative ? static_cast<std::int64_t>(0 - w) : static_cast<std::int64_t>(w);
+				return res;
+			}
+
+			/*double*/
+			static constexpr double pow10[] = {
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+			};
+			if (w == 0) {
+				res.real = negative ? -0.0 : 0.0;
+			}
+			else if (!truncated && w <= (std::uint64_t(1) << 53) && -22 <= exp10 && exp10 <= 22) {
+				const double d = static_cast<double>(w);
+				res.real = exp10 < 0 ? d / pow10[-exp10] : d * pow10[exp10];
+				if (negative) res.real = -res.real;
+			}
+			else {
+				const std::size_t sign = s[begin] == '+' ? 1 : 0;
+				const std::string copy = s.contiguous() ? std::string() : s.substr(begin + sign, itr - begin - sign);
+				const char* first = s.contiguous() ? s.data() + begin + sign : copy.data();
+				const auto r = std::from_chars(first, first + (itr - begin - sign), res.real);
+				if (r.ec == std::errc::result_out_of_range) {
+					const double inf = std::numeric_limits<double>::infinity();
+					res.real = exp10 + digits > 0 ? (negative ? -inf : inf) : (negative ? -0.0 : 0.0);
+				}
+			}
+			return res;
+		}
+
+		/*token with the scanned value*/
+		static SyntaxTree token(std::size_t token_id, const Input& s, const std::size_t begin, const Scan& res) {
+			auto&& tree = Tree::Token(token_id, s, begin, res.length);
+			if (!tree.first.empty()) {
+				if (res.is_integer) tree.first[0]->setInteger(res.integer);
+				else tree.first[0]->setReal(res.real);
+			}
+			return std::move(tree);
+		}
+	};
+
 	/*
 	one digit term
 	- Digit = "0" | "1" | "2" | "3" | "4" | "5" | "6" | "7" | "8" | "9"; 
@@ -47,19 +268,16 @@ namespace cebnf {
 		std::size_t TokenID = cebnf_expanded_type::digit;
 		std::string _s = "";
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
-
-			std::size_t itr = begin;
-			std::string _s = "";
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return Tree::Token(TokenID, s, begin, match_impl(s, begin));
+		}
 
-			if ('0' <= s[itr] && s[itr] <= '9') {
-				_s += s[itr];
-				return Tree::Create(TokenID, _s, _s.length());
-			}
-			else {
-				return Tree::Create();
-			}
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			return ('0' <= s[begin] && s[begin] <= '9') ? 1 : no_match;
+		}
 
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarHelper::describe(e, "cebnf::Digit()", TokenID, GrammarHelper::bits("0-9"));
 		}
 	};
 
@@ -72,18 +290,16 @@ namespace cebnf {
 		std::size_t TokenID = cebnf_expanded_type::digit_excluding_zero;
 		std::string _s = "";
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
-			std::size_t itr = begin;
-			std::string _s = "";
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return Tree::Token(TokenID, s, begin, match_impl(s, begin));
+		}
 
-			if ('1' <= s[itr] && s[itr] <= '9') {
-				_s += s[itr];
-				return Tree::Create(TokenID, _s, _s.length());
-			}
-			else {
-				return Tree::Create();
-			}
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			return ('1' <= s[begin] && s[begin] <= '9') ? 1 : no_match;
+		}
 
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarHelper::describe(e, "cebnf::DigitExcludingZero()", TokenID, GrammarHelper::bits("1-9"));
 		}
 	};
 
@@ -96,28 +312,30 @@ namespace cebnf {
 		std::size_t TokenID = cebnf_expanded_type::natural_number;
 		std::string _s = "";
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return Tree::Token(TokenID, s, begin, match_impl(s, begin));
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
 
 			std::size_t itr = begin;
-			std::string _s = "";
 
 			if ('1' <= s[itr] && s[itr] <= '9') {
-				_s += s[itr++];
+				itr++;
 			}
 			else {
-				return Tree::Create();
+				return no_match;
 			}
 
-			while (true) {
-
-				if ('0' <= s[itr] && s[itr] <= '9') {
-					_s += s[itr++];
-				}
-				else {
-					return Tree::Create(TokenID, _s, _s.length());
-				}
+			while ('0' <= s[itr] && s[itr] <= '9') {
+				itr++;
 			}
 
+			return itr - begin;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarHelper::describe(e, "cebnf::NaturalNumber()", TokenID, GrammarHelper::bits("1-9"));
 		}
 	};
 	
@@ -130,36 +348,39 @@ namespace cebnf {
 		std::size_t TokenID = cebnf_expanded_type::integer;
 		std::string _s = "";
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
+		/*token value: getInteger() / getReal()*/
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return NumberHelper::token(TokenID, s, begin, NumberHelper::scan(s, begin, NumberHelper::integer_form));
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
 
 			std::size_t itr = begin;
-			std::string _s = "";
 
 			if (s[itr] == '+' || s[itr] == '-') {
-				_s += s[itr++];
+				itr++;
 			}
 
 			if (s[itr] == '0') {
-				_s += s[itr];
-				return Tree::Create(TokenID, _s, _s.length());
-			}else if('1' <= s[itr] && s[itr] <= '9'){
-				_s += s[itr++];
-
-				while (true) {
+				return itr - begin + 1;
+			}
+			else if ('1' <= s[itr] && s[itr] <= '9') {
+				itr++;
 
-					if ('0' <= s[itr] && s[itr] <= '9') {
-						_s += s[itr++];
-					}
-					else {
-						return Tree::Create(TokenID, _s, _s.length());
-					}
+				while ('0' <= s[itr] && s[itr] <= '9') {
+					itr++;
 				}
+				return itr - begin;
 			}
 			else {
-				return Tree::Create();
+				return no_match;
 			}
 
 		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarHelper::describe(e, "cebnf::Integer()", TokenID, GrammarHelper::bits("0-9+-"));
+		}
 	};
 
 	/*
@@ -171,35 +392,31 @@ namespace cebnf {
 		std::size_t TokenID = cebnf_expanded_type::real_number;
 		std::string _s = "";
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
+		/*token value: getInteger() / getReal()*/
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return NumberHelper::token(TokenID, s, begin, NumberHelper::scan(s, begin, NumberHelper::real_form));
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
 
 			std::size_t itr = begin;
-			std::string _s = "";
 			bool exist_integer_area = true;
 			bool exist_after_the_decimal_point = true;
 
 			/*integer area*/
 
 			if (s[itr] == '+' || s[itr] == '-') {
-				_s += s[itr++];
+				itr++;
 			}
 
 			if (s[itr] == '0') {
-				_s += s[itr++];
-				//return Tree::Create(TokenID, _s, _s.length());
+				itr++;
 			}
 			else if ('1' <= s[itr] && s[itr] <= '9') {
-				_s += s[itr++];
-
-				while (true) {
+				itr++;
 
-					if ('0' <= s[itr] && s[itr] <= '9') {
-						_s += s[itr++];
-					}
-					else {
-						break;
-						//return Tree::Create(TokenID, _s, _s.length());
-					}
+				while ('0' <= s[itr] && s[itr] <= '9') {
+					itr++;
 				}
 			}
 			else {
@@ -209,26 +426,19 @@ namespace cebnf {
 			/* must exist the decimal point. */
 
 			if (s[itr] == '.') {
-				_s += s[itr++];
+				itr++;
 			}
 			else {
-				return Tree::Create();
+				return no_match;
 			}
 
 			/*after the decimal point*/
 
 			if ('0' <= s[itr] && s[itr] <= '9') {
-				_s += s[itr++];
+				itr++;
 
-				while (true) {
-					if ('0' <= s[itr] && s[itr] <= '9') {
-						_s += s[itr++];
-						//return Tree::Create(TokenID, _s, _s.length());
-					}
-					else {
-						break;
-						//return Tree::Create();
-					}
+				while ('0' <= s[itr] && s[itr] <= '9') {
+					itr++;
 				}
 			}
 			else {
@@ -238,14 +448,42 @@ namespace cebnf {
 			/*finish*/
 
 			if (exist_integer_area || exist_after_the_decimal_point) {
-				return Tree::Create(TokenID, _s, _s.length());
+				return itr - begin;
 			}
 			else {
-				return Tree::Create();
+				return no_match;
 			}
 
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarHelper::describe(e, "cebnf::RealNumber()", TokenID, GrammarHelper::bits("0-9.+-"));
+		}
+	};
+
+	/*
+	number with an exponent (JSON number)
+	- Number = ( Integer | RealNumber ) , [ ( "E" | "e" ) , Integer ];
+	one token, integers without "." and exponent keep an int64 value, others a double value.
+	*/
+	struct Number : public CEBNFBase, tagValue {
 
+		std::size_t TokenID = cebnf_expanded_type::number;
+		std::string _s = "";
 
+		Number() {}
+		explicit Number(std::size_t token_id) : TokenID(token_id) {}
+
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return NumberHelper::token(TokenID, s, begin, NumberHelper::scan(s, begin, NumberHelper::number_form));
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			return NumberHelper::scan(s, begin, NumberHelper::number_form, false).length;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarHelper::describe(e, "cebnf::Number()", TokenID, GrammarHelper::bits("0-9.+-"));
 		}
 	};
 
@@ -254,25 +492,7 @@ namespace cebnf {
 	struct StringHelper {
 
 		static std::string stringHexWard() {
-			return u8"0123456789abcdefABCDEF";
-		}
-
-		/*input second character :: \x -> changeEscapeSequence('x'), return std::string("\x")*/
-		static std::string changeEscapeSequence(const char c){
-			switch (c) {
-			case '\"': return std::string("\"");
-			case '\'': return std::string("\'");
-			case 'n' : return std::string("\n");
-			case '\\': return std::string("\\");
-			case '\?': return std::string("\?");
-			case 't' : return std::string("\t");
-			case 'b' : return std::string("\b");
-			case 'r' : return std::string("\r");
-			case 'f' : return std::string("\f");
-			case 'v' : return std::string("\v");
-			case 'a' : return std::string("\a");
-			default  : return std::string("");
-			}
+			return "0123456789abcdefABCDEF";
 		}
 
 		/* Unicode codepoint to UTF-8
@@ -326,6 +546,82 @@ namespace cebnf {
 			return std::array<uint32_t, 2>{(codepoint - 0x10000) / 0x400 + 0xD800, (codepoint - 0x10000) % 0x400 + 0xDC00};
 		}
 
+		/*input second character :: \x -> escapeChar('x'), -1 if not an escape sequence (no allocation)*/
+		static int escapeChar(const char c) {
+			switch (c) {
+			case '\"': return '\"';
+			case '\'': return '\'';
+			case 'n' : return '\n';
+			case '\\': return '\\';
+			case '\?': return '\?';
+			case 't' : return '\t';
+			case 'b' : return '\b';
+			case 'r' : return '\r';
+			case 'f' : return '\f';
+			case 'v' : return '\v';
+			case 'a' : return '\a';
+			default  : return -1;
+			}
+		}
+
+		/*hex digit -> 0 - 15, other bytes -> -1*/
+		static constexpr std::array<std::int8_t, 256> makeHexTable() {
+			std::array<std::int8_t, 256> res = {};
+			for (int c = 0; c < 256; ++c) {
+				res[c] = ('0' <= c && c <= '9') ? static_cast<std::int8_t>(c - '0')
+					: ('a' <= c && c <= 'f') ? static_cast<std::int8_t>(c - 'a' + 10)
+					: ('A' <= c && c <= 'F') ? static_cast<std::int8_t>(c - 'A' + 10)
+					: static_cast<std::int8_t>(-1);
+			}
+			return res;
+		}
+
+		/*XXXX (exactly 4 hex digits at p) -> 0 - 0xFFFF, -1 if any is not a hex digit
+		four table loads, one sign test*/
+		static std::int32_t decodeHex4(const char* p) {
+			static constexpr std::array<std::int8_t, 256> hex = makeHexTable();
+			const std::int32_t d0 = hex[static_cast<unsigned char>(p[0])];
+			const std::int32_t d1 = hex[static_cast<unsigned char>(p[1])];
+			const std::int32_t d2 = hex[static_cast<unsigned char>(p[2])];
+			const std::int32_t d3 = hex[static_cast<unsigned char>(p[3])];
+			if ((d0 | d1 | d2 | d3) < 0) {
+				return -1;
+			}
+			return (d0 << 12) | (d1 << 8) | (d2 << 4) | d3;
+		}
+
+		/*encodeUTF8 without a temporary string*/
+		static void appendUTF8(std::string& dst, uint32_t codepoint) {
+			char buf[4];
+			std::size_t n;
+			if (codepoint < 0x0080) {
+				buf[0] = static_cast<char>(codepoint);
+				n = 1;
+			}
+			else if (codepoint < 0x0800) {
+				buf[0] = static_cast<char>((codepoint >> 6) | 0xc0);
+				buf[1] = static_cast<char>((codepoint & 0x3f) | 0x80);
+				n = 2;
+			}
+			else if (codepoint < 0x10000) {
+				buf[0] = static_cast<char>((codepoint >> 12) | 0xe0);
+				buf[1] = static_cast<char>(((codepoint >> 6) & 0x3f) | 0x80);
+				buf[2] = static_cast<char>((codepoint & 0x3f) | 0x80);
+				n = 3;
+			}
+			else if (codepoint <= 0x10FFFF) {
+				buf[0] = static_cast<char>((codepoint >> 18) | 0xf0);
+				buf[1] = static_cast<char>(((codepoint >> 12) & 0x3f) | 0x80);
+				buf[2] = static_cast<char>(((codepoint >> 6) & 0x3f) | 0x80);
+				buf[3] = static_cast<char>((codepoint & 0x3f) | 0x80);
+				n = 4;
+			}
+			else {
+				return;
+			}
+			dst.append(buf, n);
+		}
+
 		/* X ... XXXXXX < 10FFFF
 		return UTF8 string and loading character size
 		surplus characters are Ignored*/
@@ -336,137 +632,350 @@ namespace cebnf {
 			std::string UTF8 = encodeUTF8(codepoint);
 			return std::pair<std::string, size_t>(UTF8, check);
 		}
+	};
 
-		/* XXXX + (\uXXXX : surrogate pair)
-		return UTF8 string and loading character size
-		surplus characters are Ignored*/
-		static std::pair<std::string, size_t> toUTF8surrogate(std::string hex_string) {
-			size_t check = hex_string.find_first_not_of(StringHelper::stringHexWard());
-			
-			if (check < 4) {
-				/*error*/
-				return std::pair<std::string, size_t>(std::string(), check);
-			}
 
-			/* later, check >= 4 and use length is 4 */
+	/*
+	one small alphabet
+	- AlphabetS = "a" | "b" | "c" | "d" | ... | "w" | "x" | "y" | "z";
+	*/
+	struct AlphabetS : public CEBNFBase, tagValue {
 
-			uint32_t codepoint = std::stoul(hex_string.substr(0, 4), nullptr, 16);
+		std::size_t TokenID = cebnf_expanded_type::alphabet_s;
+		std::string _s = "";
 
-			/*if surrogate pair*/
-			if (isSurrogatePair_High(codepoint)) {
-				if (hex_string.length() != 10) {
-					/*error*/
-					return std::pair<std::string, size_t>(std::string(), 4);
-				}
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return Tree::Token(TokenID, s, begin, match_impl(s, begin));
+		}
 
-				if (hex_string[4] != '\\' || hex_string[5] != 'u') {
-					/*error*/
-					return std::pair<std::string, size_t>(std::string(), 4);
-				}
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			return ('a' <= s[begin] && s[begin] <= 'z') ? 1 : no_match;
+		}
 
-				size_t check2 = hex_string.substr(6).find_first_not_of(StringHelper::stringHexWard());
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarHelper::describe(e, "cebnf::AlphabetS()", TokenID, GrammarHelper::bits("a-z"));
+		}
+	};
 
-				if (check2 < 4) {
-					/*error*/
-					return std::pair<std::string, size_t>(std::string(), 4 + 2 + check2);
-				}
+	/*
+	one large alphabet
+	- AlphabetL = "A" | "B" | "C" | "D" | ... | "W" | "X" | "Y" | "Z";
+	*/
+	struct AlphabetL : public CEBNFBase, tagValue {
 
-				/* later, check2 >= 4 and use length is 4 */
+		std::size_t TokenID = cebnf_expanded_type::alphabet_l;
+		std::string _s = "";
 
-				uint32_t codepoint2 = std::stoul(hex_string.substr(6, 4), nullptr, 16);
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return Tree::Token(TokenID, s, begin, match_impl(s, begin));
+		}
 
-				if (isSurrogatePair_Low(codepoint2)) {
-					std::string UTF8 = encodeUTF8(surrogate2codepoint(codepoint, codepoint2));
-					return std::pair<std::string, size_t>(UTF8, 4 + 2 + 4);
-				}
-				else {
-					/*error*/
-					return std::pair<std::string, size_t>(std::string(), 4 + 2 + 4);
-				}
-			}
-			/*not surrogate pair*/
-			else {
-				std::string UTF8 = encodeUTF8(codepoint);
-				return std::pair<std::string, size_t>(UTF8, 4);
-			}
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			return ('A' <= s[begin] && s[begin] <= 'Z') ? 1 : no_match;
+		}
 
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarHelper::describe(e, "cebnf::AlphabetL()", TokenID, GrammarHelper::bits("A-Z"));
 		}
+	};
+
+	/*
+	one large or small alphabet
+	- Alphabet = AlphabetL | AlphabetS;
+	*/
+	struct Alphabet : public CEBNFBase, tagValue {
 
+		std::size_t TokenID = cebnf_expanded_type::alphabet;
+		std::string _s = "";
+
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return Tree::Token(TokenID, s, begin, match_impl(s, begin));
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			return (('A' <= s[begin] && s[begin] <= 'Z') || ('a' <= s[begin] && s[begin] <= 'z')) ? 1 : no_match;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarHelper::describe(e, "cebnf::Alphabet()", TokenID, GrammarHelper::bits("a-zA-Z"));
+		}
 	};
 
+	/*-------------------------------------------------------------------------------*/
 
 	/*
-	one small alphabet
-	- AlphabetS = "a" | "b" | "c" | "d" | ... | "w" | "x" | "y" | "z";
+	one character of a set (256-bit bitmap)
+	- CharSet("a-zA-Z_") = "a" | ... | "z" | "A" | ... | "Z" | "_";
+	"x-y" is a range, other characters are listed. "-" at the head or the tail is listed.
 	*/
-	struct AlphabetS : public CEBNFBase, tagValue {
+	struct CharSet : public CEBNFBase, tagValue {
 
-		std::size_t TokenID = cebnf_expanded_type::alphabet_s;
-		std::string _s = "";
+		std::size_t TokenID = cebnf_expanded_type::char_set;
+		std::array<std::uint64_t, 4> _bits = {};
+		simd::ByteRanges _ranges;
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
+		CharSet() {}
+		CharSet(const std::string& pattern)                       { addPattern(pattern); }
+		CharSet(const char*        pattern)                       { addPattern(pattern); }
+		CharSet(const char first, const char last)                { addRange(first, last); }
 
-			std::size_t itr = begin;
-			std::string _s = "";
+		CharSet(const std::string& pattern, std::size_t token_id) : TokenID(token_id) { addPattern(pattern); }
+		CharSet(const char*        pattern, std::size_t token_id) : TokenID(token_id) { addPattern(pattern); }
+
+		/*from the bitmap (_bits)*/
+		CharSet(const std::array<std::uint64_t, 4>& bits)                        : _bits(bits)                     { updateRanges(); }
+		CharSet(const std::array<std::uint64_t, 4>& bits, std::size_t token_id) : TokenID(token_id), _bits(bits) { updateRanges(); }
+
+		/*return a copy with [first, last] added*/
+		CharSet range(const char first, const char last) const {
+			CharSet res(*this);
+			res.addRange(first, last);
+			return res;
+		}
+
+		/*return a copy with every character of list added*/
+		CharSet list(const std::string& list) const {
+			CharSet res(*this);
+			for (auto c : list) res.set(static_cast<unsigned char>(c));
+			res.updateRanges();
+			return res;
+		}
+
+		/*return the complement*/
+		CharSet invert() const {
+			CharSet res(*this);
+			for (auto& b : res._bits) b = ~b;
+			res.updateRanges();
+			return res;
+		}
 
-			if ('a' <= s[itr] && s[itr] <= 'z') {
-				_s += s[itr];
-				return Tree::Create(TokenID, _s, _s.length());
+		bool contains(const unsigned char c) const {
+			return (_bits[c >> 6] >> (c & 63)) & 1;
+		}
+
+		/*length of the leading run of characters in the set*/
+		std::size_t span(const char* p, std::size_t n) const {
+			if (_ranges.size >= 0) {
+				return simd::spanRanges(p, n, _ranges);
 			}
-			else {
-				return Tree::Create();
+
+			std::size_t i = 0;
+			while (i < n && contains(static_cast<unsigned char>(p[i]))) ++i;
+			return i;
+		}
+
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return Tree::Token(TokenID, s, begin, match_impl(s, begin));
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			return (begin < s.size() && contains(static_cast<unsigned char>(s[begin]))) ? 1 : no_match;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarHelper::describe(e, "cebnf::CharSet(" + GrammarHelper::bitsLiteral(_bits) + ")", TokenID, _bits);
+		}
+
+	private:
+		void set(const unsigned char c) {
+			_bits[c >> 6] |= std::uint64_t(1) << (c & 63);
+		}
+
+		void addRange(const char first, const char last) {
+			for (unsigned int c = static_cast<unsigned char>(first); c <= static_cast<unsigned char>(last); ++c) {
+				set(static_cast<unsigned char>(c));
 			}
+			updateRanges();
+		}
+
+		void addPattern(const std::string& pattern) {
+			const std::array<std::uint64_t, 4> bits = GrammarHelper::bits(pattern);
+			for (std::size_t i = 0; i < 4; ++i) _bits[i] |= bits[i];
+			updateRanges();
+		}
 
+		/*bitmap -> ranges for the vector paths*/
+		void updateRanges() {
+			_ranges.size = 0;
+			unsigned int c = 0;
+			while (c < 256) {
+				if (!contains(static_cast<unsigned char>(c))) { ++c; continue; }
+
+				unsigned int last = c;
+				while (last + 1 < 256 && contains(static_cast<unsigned char>(last + 1))) ++last;
+
+				if (_ranges.size == simd::ByteRanges::max_ranges) {
+					_ranges.size = -1;
+					return;
+				}
+				_ranges.lo[_ranges.size] = static_cast<unsigned char>(c);
+				_ranges.hi[_ranges.size] = static_cast<unsigned char>(last);
+				_ranges.size++;
+				c = last + 1;
+			}
 		}
 	};
 
 	/*
-	one large alphabet
-	- AlphabetL = "A" | "B" | "C" | "D" | ... | "W" | "X" | "Y" | "Z";
+	run of CharSet characters as one token (at least one character)
+	- Span(CharSet("a-z")) = CharSet("a-z") , { CharSet("a-z") };
+	the run is scanned 16/32 bytes at a time, only one node is created.
 	*/
-	struct AlphabetL : public CEBNFBase, tagValue {
+	struct Span : public CEBNFBase, tagValue {
 
-		std::size_t TokenID = cebnf_expanded_type::alphabet_l;
-		std::string _s = "";
+		std::size_t TokenID = cebnf_expanded_type::span;
+		CharSet _set;
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
+		Span(const CharSet& set)                       : _set(set)                     {}
+		Span(const CharSet& set, std::size_t token_id) : TokenID(token_id), _set(set) {}
 
-			std::size_t itr = begin;
-			std::string _s = "";
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return Tree::Token(TokenID, s, begin, match_impl(s, begin));
+		}
 
-			if ('A' <= s[itr] && s[itr] <= 'Z') {
-				_s += s[itr];
-				return Tree::Create(TokenID, _s, _s.length());
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			if (begin >= s.size()) {
+				return no_match;
 			}
-			else {
-				return Tree::Create();
+
+			const std::size_t n = s.scan(begin, [this](const char* p, std::size_t n) { return _set.span(p, n); });
+			return n == 0 ? no_match : n;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarHelper::describe(e, "cebnf::Span(cebnf::CharSet(" + GrammarHelper::bitsLiteral(_set._bits) + "))", TokenID, _set._bits);
+		}
+	};
+
+	/*
+	one UTF-8 code point of Unicode categories
+	- UnicodeChar(unicode::letter | unicode::digit) = (Lu | Ll | Lt | Lm | Lo | Nd) code point;
+	invalid UTF-8 does not match.
+	*/
+	struct UnicodeChar : public CEBNFBase, tagValue {
+
+		std::size_t TokenID = cebnf_expanded_type::unicode_char;
+		unsigned int _categories;
+
+		UnicodeChar(unsigned int categories)                       : _categories(categories)                     {}
+		UnicodeChar(unsigned int categories, std::size_t token_id) : TokenID(token_id), _categories(categories) {}
+
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return Tree::Token(TokenID, s, begin, match_impl(s, begin));
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			if (begin >= s.size()) {
+				return no_match;
 			}
 
+			std::uint32_t cp;
+			char buf[4];
+			const std::size_t len = unicode::decodeUTF8(codePoint(s, begin, buf), std::min<std::size_t>(s.size() - begin, 4), cp);
+			return (len != 0 && (unicode::categoryOf(cp) & _categories) != 0) ? len : no_match;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			/*ASCII of the categories and UTF-8 lead bytes*/
+			std::array<std::uint64_t, 4> first = GrammarHelper::bits(std::string("\xC2-\xF4"));
+			for (std::uint32_t c = 0; c < 0x80; ++c) {
+				if (unicode::categoryOf(c) & _categories) first[c >> 6] |= std::uint64_t(1) << (c & 63);
+			}
+			GrammarHelper::describe(e, "cebnf::UnicodeChar(" + std::to_string(_categories) + ")", TokenID, first);
+		}
+
+		/*the bytes of the code point at s[pos]: in place, or copied to buf (segments, it can cross pieces)*/
+		static const char* codePoint(const Input& s, std::size_t pos, char (&buf)[4]) {
+			if (s.contiguous()) {
+				return s.data() + pos;
+			}
+			for (std::size_t i = 0; i < 4; ++i) buf[i] = s[pos + i];
+			return buf;
 		}
 	};
 
 	/*
-	one large or small alphabet
-	- Alphabet = AlphabetL | AlphabetS;
+	run of UnicodeChar code points as one token (at least one code point)
+	- UnicodeSpan(unicode::letter) = UnicodeChar(unicode::letter) , { UnicodeChar(unicode::letter) };
+	ASCII runs are scanned by a CharSet (16/32 bytes at a time), only other code points are decoded.
 	*/
-	struct Alphabet : public CEBNFBase, tagValue {
+	struct UnicodeSpan : public CEBNFBase, tagValue {
 
-		std::size_t TokenID = cebnf_expanded_type::alphabet;
-		std::string _s = "";
+		std::size_t TokenID = cebnf_expanded_type::unicode_span;
+		unsigned int _categories;
+		CharSet _ascii;
+
+		UnicodeSpan(unsigned int categories)                       : _categories(categories), _ascii(asciiSet(categories))                     {}
+		UnicodeSpan(unsigned int categories, std::size_t token_id) : TokenID(token_id), _categories(categories), _ascii(asciiSet(categories)) {}
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return Tree::Token(TokenID, s, begin, match_impl(s, begin));
+		}
 
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			if (!s.contiguous()) {
+				return matchSegments(s, begin);
+			}
+
+			const char* p = s.data();
+			const std::size_t n = s.size();
 			std::size_t itr = begin;
-			std::string _s = "";
 
-			if (('A' <= s[itr] && s[itr] <= 'Z') || ('a' <= s[itr] && s[itr] <= 'z')) {
-				_s += s[itr];
-				return Tree::Create(TokenID, _s, _s.length());
+			while (itr < n) {
+				itr += _ascii.span(p + itr, n - itr);
+				if (itr >= n || static_cast<unsigned char>(p[itr]) < 0x80) {
+					break;
+				}
+
+				std::uint32_t cp;
+				const std::size_t len = unicode::decodeUTF8(p + itr, n - itr, cp);
+				if (len == 0 || (unicode::categoryOf(cp) & _categories) == 0) {
+					break;
+				}
+				itr += len;
 			}
-			else {
-				return Tree::Create();
+			return itr == begin ? no_match : itr - begin;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			/*ASCII of the categories and UTF-8 lead bytes*/
+			std::array<std::uint64_t, 4> first = _ascii._bits;
+			const std::array<std::uint64_t, 4> lead = GrammarHelper::bits(std::string("\xC2-\xF4"));
+			for (std::size_t i = 0; i < 4; ++i) first[i] |= lead[i];
+			GrammarHelper::describe(e, "cebnf::UnicodeSpan(" + std::to_string(_categories) + ")", TokenID, first);
+		}
+
+	private:
+		/*segments: byte by byte through s[]*/
+		std::size_t matchSegments(const Input& s, const std::size_t begin) const {
+			const std::size_t n = s.size();
+			std::size_t itr = begin;
+
+			while (itr < n) {
+				const unsigned char c = static_cast<unsigned char>(s[itr]);
+				if (c < 0x80) {
+					if (!_ascii.contains(c)) break;
+					itr++;
+					continue;
+				}
+
+				std::uint32_t cp;
+				char buf[4];
+				const std::size_t len = unicode::decodeUTF8(UnicodeChar::codePoint(s, itr, buf), std::min<std::size_t>(n - itr, 4), cp);
+				if (len == 0 || (unicode::categoryOf(cp) & _categories) == 0) {
+					break;
+				}
+				itr += len;
 			}
+			return itr == begin ? no_match : itr - begin;
+		}
 
+		static CharSet asciiSet(unsigned int categories) {
+			std::string list;
+			for (std::uint32_t c = 0; c < 0x80; ++c) {
+				if (unicode::categoryOf(c) & categories) list += static_cast<char>(c);
+			}
+			return CharSet().list(list);
 		}
 	};
 
@@ -483,7 +992,7 @@ namespace cebnf {
 
 		StringIE(const char left_enclosure, const char right_enclosure) : _left_enclosure(left_enclosure), _right_enclosure(right_enclosure) {}
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
 
 			std::size_t itr = begin;
 			std::string _s = "";
@@ -502,11 +1011,11 @@ namespace cebnf {
 
 				if (s[itr] == _right_enclosure) {
 					//_s += s[itr++];
-					auto&& ldq = Tree::Create(cebnf_expanded_type::left_enclosure, _l, 1);
-					auto&& main = Tree::Create(cebnf_expanded_type::string, _s, _s.length());
-					auto&& rdq = Tree::Create(cebnf_expanded_type::right_enclosure, _r, 1);
+					auto&& ldq = Tree::Create(cebnf_expanded_type::left_enclosure, _l, 1, begin);
+					auto&& main = Tree::Create(cebnf_expanded_type::string, _s, _s.length(), begin + 1);
+					auto&& rdq = Tree::Create(cebnf_expanded_type::right_enclosure, _r, 1, itr);
 
-					auto&& I = Tree::Create(TokenID, _l + _s + _r, _s.length() + 2);
+					auto&& I = Tree::Create(TokenID, _l + _s + _r, _s.length() + 2, begin);
 					I.first[0]->mergeChildren(std::move(ldq.first));
 					I.first[0]->mergeChildren(std::move(main.first));
 					I.first[0]->mergeChildren(std::move(rdq.first));
@@ -523,6 +1032,25 @@ namespace cebnf {
 			}
 
 		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			if (s[begin] != _left_enclosure) {
+				return no_match;
+			}
+
+			std::size_t itr = begin + 1;
+			while (s[itr] != _right_enclosure) {
+				if (s[itr] == '\0') {
+					return no_match;
+				}
+				itr++;
+			}
+			return itr - begin + 1;
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarHelper::describe(e, "cebnf::StringIE(" + GrammarHelper::charLiteral(_left_enclosure) + ", " + GrammarHelper::charLiteral(_right_enclosure) + ")", TokenID, GrammarHelper::bits(std::string(1, _left_enclosure)));
+		}
 	};
 
 
@@ -539,68 +1067,158 @@ namespace cebnf {
 
 		StringIE2(const char left_enclosure, const char right_enclosure) : _left_enclosure(left_enclosure), _right_enclosure(right_enclosure) {}
 
-		virtual SyntaxTree parse_impl(const std::string& s, const std::size_t begin) override {
-
-			std::size_t itr = begin;
-			std::string _s = "";
-			std::string _l; _l += _left_enclosure;
-			std::string _r; _r += _right_enclosure;
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
 
-			if (s[itr] == _left_enclosure) {
-				//_s += s[itr++];
-				itr++;
-			}
-			else {
+			if (s[begin] != _left_enclosure) {
 				return Tree::Create();
 			}
 
-			while (true) {
+			std::string _s;
+			const std::size_t len = s.scan(begin, [&](const char* p, const std::size_t n) {
+				std::size_t itr = 1;
+				_s.clear();
 
-				if (s[itr] == _right_enclosure) {
-					//_s += s[itr++];
-					auto&& ldq = Tree::Create(cebnf_expanded_type::left_enclosure, _l, 1);
-					auto&& main = Tree::Create(cebnf_expanded_type::string, _s, _s.length());
-					auto&& rdq = Tree::Create(cebnf_expanded_type::right_enclosure, _r, 1);
+				while (true) {
 
-					auto&& I = Tree::Create(TokenID, _l + _s + _r, itr - begin + 1);
-					I.first[0]->mergeChildren(std::move(ldq.first));
-					I.first[0]->mergeChildren(std::move(main.first));
-					I.first[0]->mergeChildren(std::move(rdq.first));
+					/*copy the run up to the next enclosure, escape or NUL at once*/
+					const std::size_t run = simd::findFirstOf(p + itr, n - itr, _right_enclosure, '\\', '\0');
+					_s.append(p + itr, run);
+					itr += run;
 
-					return std::move(I);
-				}
-				else if (s[itr] == '\0') {
-					return Tree::Create();
-				}
-				else if (s[itr] == '\\') {
+					if (itr >= n || p[itr] == '\0') {
+						return no_match;
+					}
+					else if (p[itr] == _right_enclosure) {
+						break;
+					}
+
+					/*escape sequence*/
 					itr++;
-					if (s[itr] == 'n' || s[itr] == '\'' || s[itr] == '\"' || s[itr] == '\\' || s[itr] == '\?' || s[itr] == 't' || s[itr] == 'b' || s[itr] == 'r' || s[itr] == 'f' || s[itr] == 'v' || s[itr] == 'a') {
-						//_s += '\\';
-						_s += StringHelper::changeEscapeSequence(/* \\ + */ s[itr]);
+					const int c = itr < n ? StringHelper::escapeChar(p[itr]) : -1;
+					if (c >= 0) {
+						_s += static_cast<char>(c);
 						itr++;
 					}
-					else if (s[itr] == 'u') {
+					else if (itr < n && p[itr] == 'u') {
 						itr++;
-						std::string subs = s.substr(itr, std::min<unsigned int>(10U, s.length() - itr));
-						auto utf8 = StringHelper::toUTF8surrogate(subs);
-						if (utf8.first == std::string()) {
-							return Tree::Create();
+						const std::int32_t cp = n - itr >= 4 ? StringHelper::decodeHex4(p + itr) : -1;
+						if (cp < 0) {
+							return no_match;
+						}
+						itr += 4;
+
+						/*surrogate pair :: \uD8XX\uDCXX*/
+						if (StringHelper::isSurrogatePair_High(cp)) {
+							const std::int32_t low = (n - itr >= 6 && p[itr] == '\\' && p[itr + 1] == 'u') ? StringHelper::decodeHex4(p + itr + 2) : -1;
+							if (low < 0 || !StringHelper::isSurrogatePair_Low(low)) {
+								return no_match;
+							}
+							StringHelper::appendUTF8(_s, StringHelper::surrogate2codepoint(cp, low));
+							itr += 6;
+						}
+						else {
+							StringHelper::appendUTF8(_s, cp);
 						}
-
-						_s += utf8.first;
-						itr += utf8.second;
 					}
-					else{
-						return Tree::Create();
+					else {
+						return no_match;
 					}
 
 				}
-				else {
-					_s += s[itr++];
-				}
+				return itr;
+			});
+			if (len == no_match) {
+				return Tree::Create();
+			}
+			const std::size_t itr = begin + len;
+
+			std::string whole;
+			whole.reserve(_s.length() + 2);
+			whole += _left_enclosure;
+			whole += _s;
+			whole += _right_enclosure;
+
+			auto&& ldq = Tree::Create(cebnf_expanded_type::left_enclosure, std::string(1, _left_enclosure), 1, begin);
+			auto&& main = Tree::Create(cebnf_expanded_type::string, std::move(_s), itr - begin - 1, begin + 1);
+			auto&& rdq = Tree::Create(cebnf_expanded_type::right_enclosure, std::string(1, _right_enclosure), 1, itr);
 
+			auto&& I = Tree::Create(TokenID, std::move(whole), itr - begin + 1, begin);
+			I.first[0]->mergeChildren(std::move(ldq.first));
+			I.first[0]->mergeChildren(std::move(main.first));
+			I.first[0]->mergeChildren(std::move(rdq.first));
+
+			return std::move(I);
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarHelper::describe(e, "cebnf::StringIE2(" + GrammarHelper::charLiteral(_left_enclosure) + ", " + GrammarHelper::charLiteral(_right_enclosure) + ")", TokenID, GrammarHelper::bits(std::string(1, _left_enclosure)));
+		}
+	};
+
+
+	/*
+	balanced delimiters as one token :: open , { quoted string | balanced | other } , close
+	- Balanced('{', '}') = "{" ... "}" with nested "{ }", brackets in "..." (escape \) are not counted
+	structural scan only (16/32 bytes at a time): the content is not parsed. span of lazy rules (CEBNF::setLazy).
+	*/
+	struct Balanced : public CEBNFBase, tagValue {
+
+		std::size_t TokenID = cebnf_expanded_type::balanced;
+		char _open;
+		char _close;
+		char _quote;
+		char _escape;
+
+		Balanced(const char open, const char close, const char quote = '"', const char escape = '\\') : _open(open), _close(close), _quote(quote), _escape(escape) {}
+
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			return Tree::Token(TokenID, s, begin, match_impl(s, begin));
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			if (begin >= s.size() || s[begin] != _open) {
+				return no_match;
 			}
 
+			return s.scan(begin, [this](const char* p, const std::size_t n) {
+				std::size_t depth = 1;
+				std::size_t itr = 1;
+				while (true) {
+					itr += simd::findFirstOf(p + itr, n - itr, _open, _close, _quote);
+					if (itr >= n) {
+						return no_match;
+					}
+
+					const char c = p[itr++];
+					if (c == _quote) {
+						/*skip the quoted string*/
+						while (true) {
+							itr += simd::findFirstOf(p + itr, n - itr, _quote, _escape, _quote);
+							if (itr >= n) {
+								return no_match;
+							}
+							if (p[itr] == _escape) {
+								itr += 2;
+								if (itr > n) return no_match;
+								continue;
+							}
+							itr++;
+							break;
+						}
+					}
+					else if (c == _open) {
+						depth++;
+					}
+					else if (--depth == 0) {
+						return itr;
+					}
+				}
+			});
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			GrammarHelper::describe(e, "cebnf::Balanced(" + GrammarHelper::charLiteral(_open) + ", " + GrammarHelper::charLiteral(_close) + ", "
+				+ GrammarHelper::charLiteral(_quote) + ", " + GrammarHelper::charLiteral(_escape) + ")", TokenID, GrammarHelper::bits(std::string(1, _open)));
 		}
 	};
 
@@ -0,0 +1,490 @@
+#pragma once
+
+
+#include "cebnf.hpp"
+#include "cebnf_grammar.hpp"
+#include "cebnf_ebnf.hpp"
+#include "cebnf_binary.hpp"
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+/*prepared grammar image: the rules, definitions, FIRST sets and nullable flags of GrammarInfo in one byte string
+
+image     :: "CEBG" , version(1 byte) , varint primitive_count , { primitive } , varint rule_count , { rule } , { expr } , skipper
+primitive :: varint token_id , varint text_length , text , first          (helper token: its C++ expression)
+rule      :: varint token_id , shape(1 byte) , nullable(1 byte) , first   (then the definitions in the order of the rules)
+skipper   :: 0(1 byte) | 1(1 byte) , first , expr                          (skipper of the start rule, FIRST of the skipper)
+first     :: 32 bytes (bit c of byte c / 8)
+expr      :: kind(1 byte, GrammarExpr::kind_t) , then by kind
+             term: varint token_id , varint length , bytes | rule: varint rule | primitive: varint primitive
+             seq, alt: varint count , { expr } | opt, drop: expr | rep: varint min , varint max , expr | mul: varint min , expr
+             lexeme: varint token_id , expr | node: varint token_id , shape(1 byte) , expr
+
+GrammarImage().encode(start, bytes) stores GrammarInfo(start), optimized first (GrammarInfo::optimize).
+image.load(p, n, options) creates the rules from the image without parsing a grammar nor running the analysis,
+info() is the analysis of the image (Searcher(rule, image.info()), grammar tools).
+helper tokens are not serialized: options.bind(e) gives their objects, matched by C++ expression and token id.
+toCpp(bytes, name) is a header with the image as an array (grammar embedded in the executable).
+not stored: lazy rules (loaded as eager rules), skippers of the rules other than start. pratt and user defined
+expressions cannot be encoded.
+
+example:
+	cebnf::GrammarImage().encode(grammar._jbase, bytes);                                   // build step
+	cebnf::GrammarImage image;
+	image.load(reinterpret_cast<const char*>(json_image), sizeof(json_image), options);   // startup
+	auto tree = image.start()->parse(text);
+*/
+namespace cebnf {
+
+	/*inlined rule (GrammarExpr::node of GrammarInfo::optimize): the node of the rule around its child, with the shape of the rule*/
+	struct EbnfNode final : public CEBNFBase, tagOperator {
+
+		std::size_t TokenID;
+		tree_shape _shape;
+		EbnfRef _a;
+
+		EbnfNode(std::size_t token_id, tree_shape shape, EbnfRef a) : TokenID(token_id), _shape(shape), _a(a) {}
+
+
+		virtual SyntaxTree parse_impl(const Input& s, const std::size_t begin) const override {
+			SyntaxTree&& children = Child::parse(_a, s, begin);
+			if (Tree::Failed(children)) {
+				return Tree::Create();
+			}
+			if (_shape == shape_omit || (_shape == shape_collapse && children.first.size() == 1 && !Tree::IsEpsilon(children))) {
+				return std::move(children);
+			}
+
+			auto&& I = Tree::Create(TokenID, s.substr(begin, children.second), children.second, begin);
+			if (!Tree::IsEpsilon(children)) {
+				I.first[0]->mergeChildren(std::move(children.first));
+			}
+			return std::move(I);
+		}
+
+		virtual std::size_t match_impl(const Input& s, const std::size_t begin) const override {
+			return Child::match(_a, s, begin);
+		}
+
+		virtual void describe(GrammarExpr& e) const override {
+			e.kind = GrammarExpr::node;
+			e.token_id = TokenID;
+			e.shape = _shape;
+			e.children.resize(1);
+			_a.describe(e.children[0]);
+		}
+	};
+
+	/*rules loaded from a grammar image. rules are referenced by address: movable, not copyable*/
+	class GrammarImage {
+	public:
+		/*image of the grammar of start. false: error() (user defined expressions, pratt, undefined rules)*/
+		bool encode(const CEBNFBase& start, std::string& bytes, bool optimize = true) {
+			_error.clear();
+			GrammarInfo info(start);
+			if (optimize) info.optimize();
+
+			std::vector<const GrammarExpr*> prims;
+			std::string defs;
+			for (std::size_t k = 0; k < info.rules().size(); ++k) {
+				if (!info.rules()[k].defined) {
+					_error = "rule " + std::to_string(k) + " (token id " + std::to_string(info.rules()[k].token_id) + ") is not defined";
+					return false;
+				}
+				if (!writeExpr(defs, info.rules()[k].def, info, prims)) return false;
+			}
+			defs += static_cast<char>(info.hasSkipper() ? 1 : 0);
+			if (info.hasSkipper()) {
+				writeFirst(defs, info.skipperFirst());
+				if (!writeExpr(defs, info.skipper(), info, prims)) return false;
+			}
+
+			bytes.assign("CEBG");
+			bytes += version;
+			varint::write(bytes, prims.size());
+			for (const GrammarExpr* e : prims) {
+				varint::write(bytes, e->token_id);
+				varint::write(bytes, e->text.size());
+				bytes += e->text;
+				writeFirst(bytes, toByteSet(e->first));
+			}
+			varint::write(bytes, info.rules().size());
+			for (const auto& r : info.rules()) {
+				varint::write(bytes, r.token_id);
+				bytes += static_cast<char>(r.shape);
+				bytes += static_cast<char>(r.nullable ? 1 : 0);
+				writeFirst(bytes, r.first);
+			}
+			bytes += defs;
+			return true;
+		}
+
+		bool load(const std::string& bytes, const EbnfOptions& options = EbnfOptions()) {
+			return load(bytes.data(), bytes.size(), options);
+		}
+
+		/*false: error() (the previous rules are removed in any case). the bytes are not referenced after load*/
+		bool load(const char* data, std::size_t size, const EbnfOptions& options = EbnfOptions()) {
+			_rules.clear();
+			_exprs.clear();
+			_bound.clear();
+			_info.reset();
+			_error.clear();
+
+			const char* p = data;
+			const char* end = data + size;
+			if (size < 5 || std::memcmp(data, "CEBG", 4) != 0 || data[4] != version) {
+				return fail("not a grammar image");
+			}
+			p += 5;
+
+			/*helper tokens: the bindings by C++ expression and token id*/
+			std::map<std::pair<std::string, std::size_t>, const EbnfOptions::Binding*> bound;
+			for (const auto& b : options.bindings) {
+				GrammarExpr g;
+				b.second.expr->describe(g);
+				if (g.kind == GrammarExpr::primitive) bound[std::make_pair(g.text, g.token_id)] = &b.second;
+			}
+
+			std::uint64_t count;
+			if (!varint::read(p, end, count) || count > static_cast<std::uint64_t>(end - p)) return fail("broken primitive table");
+			_prims.assign(static_cast<std::size_t>(count), Primitive());
+			for (auto& prim : _prims) {
+				std::uint64_t token_id, length;
+				GrammarInfo::ByteSet first;
+				if (!varint::read(p, end, token_id) || !varint::read(p, end, length) || length > static_cast<std::uint64_t>(end - p)) return fail("broken primitive table");
+				prim.expr.kind = GrammarExpr::primitive;
+				prim.expr.token_id = static_cast<std::size_t>(token_id);
+				prim.expr.text.assign(p, static_cast<std::size_t>(length));
+				p += length;
+				if (!readFirst(p, end, first)) return fail("broken primitive table");
+				for (std::size_t c = 0; c < 256; ++c) {
+					if (first.test(c)) prim.expr.first[c >> 6] |= std::uint64_t(1) << (c & 63);
+				}
+				const auto b = bound.find(std::make_pair(prim.expr.text, prim.expr.token_id));
+				if (b == bound.end()) return fail("helper token " + prim.expr.text + " (token id " + std::to_string(token_id) + ") is not bound");
+				prim.binding = b->second;
+			}
+
+			/*all rules before the definitions (references to rules defined later)*/
+			if (!varint::read(p, end, count) || count == 0 || count > static_cast<std::uint64_t>(end - p)) return fail("broken rule table");
+			std::vector<GrammarInfo::Rule> rules(static_cast<std::size_t>(count));
+			for (std::size_t k = 0; k < rules.size(); ++k) {
+				GrammarInfo::Rule& r = rules[k];
+				std::uint64_t token_id;
+				if (!varint::read(p, end, token_id) || end - p < 2 || static_cast<unsigned char>(p[0]) > shape_omit) return fail("broken rule table");
+				r.token_id = static_cast<std::size_t>(token_id);
+				r.shape = static_cast<tree_shape>(p[0]);
+				r.nullable = p[1] != 0;
+				p += 2;
+				if (!readFirst(p, end, r.first)) return fail("broken rule table");
+				_rules.emplace_back(new Rule(r.token_id));
+				r.ref = _rules.back().get();
+				r.defined = true;
+			}
+			for (std::size_t k = 0; k < rules.size(); ++k) {
+				if (!readExpr(p, end, rules, rules[k].def, 0)) return fail("broken definition of rule " + std::to_string(k));
+			}
+
+			GrammarExpr skipper;
+			GrammarInfo::ByteSet skipper_first;
+			if (p == end) return fail("broken skipper");
+			const bool has_skipper = *p++ != 0;
+			if (has_skipper && (!readFirst(p, end, skipper_first) || !readExpr(p, end, rules, skipper, 0))) return fail("broken skipper");
+			if (p != end) return fail("bytes after the image");
+
+			/*executable rules*/
+			for (std::size_t k = 0; k < rules.size(); ++k) {
+				EbnfRef e;
+				build(rules[k].def, _rules[k].get(), e);
+				_rules[k]->setShape(rules[k].shape);
+			}
+			if (has_skipper) {
+				if (skipper.kind == GrammarExpr::primitive) {
+					const Primitive& prim = _prims[primitiveIndex(skipper)];
+					prim.binding->assign(*_rules[0], *prim.binding->expr, true);
+				}
+				else {
+					EbnfRef e;
+					build(skipper, nullptr, e);
+					_rules[0]->setSkipper(e);
+				}
+			}
+
+			_info.reset(new GrammarInfo(std::move(rules), has_skipper, std::move(skipper), skipper_first));
+			_prims.clear();
+			return true;
+		}
+
+		const std::string& error() const { return _error; }
+
+		/*start rule of the image (nullptr: nothing loaded)*/
+		Rule* start() const { return _rules.empty() ? nullptr : _rules[0].get(); }
+
+		/*rules in the order of info().rules()*/
+		const std::vector<std::unique_ptr<Rule>>& rules() const { return _rules; }
+
+		/*first rule of the token id (nullptr: none)*/
+		Rule* find(std::size_t token_id) const {
+			for (const auto& r : _rules) {
+				if (r->getTokenID() == token_id) return r.get();
+			}
+			return nullptr;
+		}
+
+		/*analysis of the loaded grammar (valid after a successful load)*/
+		const GrammarInfo& info() const { return *_info; }
+
+		/*header with the image as `static const unsigned char name[]`*/
+		static std::string toCpp(const std::string& bytes, const std::string& name) {
+			static const char hex[] = "0123456789abcdef";
+			std::string res = "#pragma once\n\n/*generated by cebnf::GrammarImage. do not edit.*/\n\n";
+			res += "static const unsigned char " + name + "[" + std::to_string(bytes.size()) + "] = {";
+			for (std::size_t i = 0; i < bytes.size(); ++i) {
+				const unsigned char c = static_cast<unsigned char>(bytes[i]);
+				res += i % 16 == 0 ? "\n\t" : " ";
+				res += "0x";
+				res += hex[c >> 4];
+				res += hex[c & 15];
+				res += ',';
+			}
+			return res + "\n};\n";
+		}
+
+		static constexpr char version = 1;
+
+	private:
+		struct Primitive {
+			GrammarExpr expr;
+			const EbnfOptions::Binding* binding = nullptr;
+		};
+
+		static void writeFirst(std::string& dst, const GrammarInfo::ByteSet& first) {
+			for (std::size_t i = 0; i < 32; ++i) {
+				unsigned char b = 0;
+				for (std::size_t j = 0; j < 8; ++j) {
+					if (first.test(i * 8 + j)) b |= static_cast<unsigned char>(1 << j);
+				}
+				dst += static_cast<char>(b);
+			}
+		}
+
+		static GrammarInfo::ByteSet toByteSet(const std::array<std::uint64_t, 4>& bits) {
+			GrammarInfo::ByteSet res;
+			for (std::size_t c = 0; c < 256; ++c) {
+				if ((bits[c >> 6] >> (c & 63)) & 1) res.set(c);
+			}
+			return res;
+		}
+
+		static bool readFirst(const char*& p, const char* end, GrammarInfo::ByteSet& first) {
+			if (end - p < 32) return false;
+			for (std::size_t i = 0; i < 32; ++i) {
+				const unsigned char b = static_cast<unsigned char>(p[i]);
+				for (std::size_t j = 0; j < 8; ++j) {
+					if ((b >> j) & 1) first.set(i * 8 + j);
+				}
+			}
+			p += 32;
+			return true;
+		}
+
+		bool writeExpr(std::string& dst, const GrammarExpr& e, const GrammarInfo& info, std::vector<const GrammarExpr*>& prims) {
+			dst += static_cast<char>(e.kind);
+			switch (e.kind) {
+			case GrammarExpr::term:
+				varint::write(dst, e.token_id);
+				varint::write(dst, e.text.size());
+				dst += e.text;
+				return true;
+			case GrammarExpr::rule:
+				varint::write(dst, info.ruleIndex(e.ref));
+				return true;
+			case GrammarExpr::primitive: {
+				std::size_t k = 0;
+				while (k < prims.size() && (prims[k]->text != e.text || prims[k]->token_id != e.token_id)) ++k;
+				if (k == prims.size()) prims.push_back(&e);
+				varint::write(dst, k);
+				return true;
+			}
+			case GrammarExpr::seq:
+			case GrammarExpr::alt:
+				varint::write(dst, e.children.size());
+				break;
+			case GrammarExpr::opt:
+			case GrammarExpr::drop:
+				break;
+			case GrammarExpr::rep:
+				varint::write(dst, e.min);
+				varint::write(dst, e.max);
+				break;
+			case GrammarExpr::mul:
+				varint::write(dst, e.min);
+				break;
+			case GrammarExpr::lexeme:
+				varint::write(dst, e.token_id);
+				break;
+			case GrammarExpr::node:
+				varint::write(dst, e.token_id);
+				dst += static_cast<char>(e.shape);
+				break;
+			case GrammarExpr::pratt:
+				_error = "pratt is not supported";
+				return false;
+			default:
+				_error = "user defined expressions cannot be stored";
+				return false;
+			}
+			for (const auto& c : e.children) {
+				if (!writeExpr(dst, c, info, prims)) return false;
+			}
+			return true;
+		}
+
+		bool readExpr(const char*& p, const char* end, const std::vector<GrammarInfo::Rule>& rules, GrammarExpr& e, std::size_t depth) const {
+			if (p == end || depth > max_depth || static_cast<unsigned char>(*p) > GrammarExpr::node) return false;
+			e.kind = static_cast<GrammarExpr::kind_t>(*p++);
+
+			std::uint64_t a = 0, b = 0;
+			std::size_t children = 1;
+			switch (e.kind) {
+			case GrammarExpr::term:
+				if (!varint::read(p, end, a) || !varint::read(p, end, b) || b > static_cast<std::uint64_t>(end - p)) return false;
+				e.token_id = static_cast<std::size_t>(a);
+				e.text.assign(p, static_cast<std::size_t>(b));
+				p += b;
+				return true;
+			case GrammarExpr::rule:
+				if (!varint::read(p, end, a) || a >= rules.size()) return false;
+				e.ref = rules[static_cast<std::size_t>(a)].ref;
+				e.token_id = rules[static_cast<std::size_t>(a)].token_id;
+				e.shape = rules[static_cast<std::size_t>(a)].shape;
+				return true;
+			case GrammarExpr::primitive:
+				if (!varint::read(p, end, a) || a >= _prims.size()) return false;
+				e = _prims[static_cast<std::size_t>(a)].expr;
+				return true;
+			case GrammarExpr::seq:
+			case GrammarExpr::alt:
+				if (!varint::read(p, end, a) || a == 0 || a > static_cast<std::uint64_t>(end - p)) return false;
+				children = static_cast<std::size_t>(a);
+				break;
+			case GrammarExpr::opt:
+			case GrammarExpr::drop:
+				break;
+			case GrammarExpr::rep:
+				if (!varint::read(p, end, a) || !varint::read(p, end, b) || a > 0xFFFFFFFFu || b > 0xFFFFFFFFu) return false;
+				e.min = static_cast<unsigned int>(a);
+				e.max = static_cast<unsigned int>(b);
+				break;
+			case GrammarExpr::mul:
+				if (!varint::read(p, end, a) || a > 0xFFFFFFFFu) return false;
+				e.min = static_cast<unsigned int>(a);
+				break;
+			case GrammarExpr::lexeme:
+				if (!varint::read(p, end, a)) return false;
+				e.token_id = static_cast<std::size_t>(a);
+				break;
+			case GrammarExpr::node:
+				if (!varint::read(p, end, a) || p == end || static_cast<unsigned char>(*p) > shape_omit) return false;
+				e.token_id = static_cast<std::size_t>(a);
+				e.shape = static_cast<tree_shape>(*p++);
+				break;
+			default:
+				return false;
+			}
+
+			e.children.resize(children);
+			for (auto& c : e.children) {
+				if (!readExpr(p, end, rules, c, depth + 1)) return false;
+			}
+			return true;
+		}
+
+		/*the executable expression of e in res. define: e is the definition of this rule*/
+		void build(const GrammarExpr& e, Rule* define, EbnfRef& res) {
+			std::vector<EbnfRef> items(e.children.size());
+			switch (e.kind) {
+			case GrammarExpr::term:
+				res = store(Term(e.text, e.token_id), define);
+				return;
+			case GrammarExpr::rule:
+				res = EbnfRef{ e.ref, false };
+				if (define != nullptr) res = store(Wrap<EbnfRef>(res), define);
+				return;
+			case GrammarExpr::primitive: {
+				const EbnfOptions::Binding& b = *_prims[primitiveIndex(e)].binding;
+				if (define != nullptr) {
+					b.assign(*define, *b.expr, false);
+					res = EbnfRef{ define, false };
+				}
+				else {
+					_bound.push_back(b.expr);
+					res = EbnfRef{ b.expr.get(), b.terminal };
+				}
+				return;
+			}
+			case GrammarExpr::drop:
+				if (e.children[0].kind == GrammarExpr::term) {
+					res = store(Drop<Term>(Term(e.children[0].text, e.children[0].token_id)), define);
+					return;
+				}
+				break;
+			default:
+				break;
+			}
+
+			for (std::size_t i = 0; i < items.size(); ++i) build(e.children[i], nullptr, items[i]);
+			switch (e.kind) {
+			case GrammarExpr::seq: res = store(EbnfSeq(std::move(items)), define); return;
+			case GrammarExpr::alt: res = store(EbnfAlt(std::move(items)), define); return;
+			case GrammarExpr::opt: res = store(May<EbnfRef>(items[0]), define); return;
+			case GrammarExpr::drop: res = store(Drop<EbnfRef>(items[0]), define); return;
+			case GrammarExpr::rep: res = store(Rep<EbnfRef>(e.min, e.max, items[0]), define); return;
+			case GrammarExpr::mul: res = store(Mul<EbnfRef>(e.min, items[0]), define); return;
+			case GrammarExpr::lexeme: res = store(Lexeme<EbnfRef>(items[0], e.token_id), define); return;
+			default: res = store(EbnfNode(e.token_id, e.shape, items[0]), define); return;
+			}
+		}
+
+		/*the expression in _exprs, or the definition of the rule*/
+		template<class E>
+		EbnfRef store(E e, Rule* define) {
+			if (define != nullptr) {
+				*define = e;
+				return EbnfRef{ define, false };
+			}
+			_exprs.emplace_back(new E(std::move(e)));
+			return EbnfRef{ _exprs.back().get(), IsTerminal<E>::value };
+		}
+
+		/*the loaded helper token of a primitive expression*/
+		std::size_t primitiveIndex(const GrammarExpr& e) const {
+			std::size_t k = 0;
+			while (_prims[k].expr.text != e.text || _prims[k].expr.token_id != e.token_id) ++k;
+			return k;
+		}
+
+		bool fail(const std::string& message) {
+			_error = message;
+			_rules.clear();
+			_exprs.clear();
+			_bound.clear();
+			_prims.clear();
+			return false;
+		}
+
+		static constexpr std::size_t max_depth = 1000;
+
+		std::vector<std::unique_ptr<Rule>> _rules;
+		std::vector<std::unique_ptr<CEBNFBase>> _exprs;
+		std::vector<std::shared_ptr<const CEBNFBase>> _bound;
+		std::vector<Primitive> _prims;
+		std::unique_ptr<GrammarInfo> _info;
+		std::string _error;
+	};
+
+}
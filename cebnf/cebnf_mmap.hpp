@@ -0,0 +1,98 @@
+#pragma once
+
+
+#include <string>
+#include <cstddef>
+
+#if _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cebnf {
+
+	/*read-only memory mapped file
+	- data() is valid while the MappedFile lives. an empty file maps to data() == nullptr, size() == 0.*/
+	class MappedFile {
+	public:
+		MappedFile() {}
+		MappedFile(const std::string& path) { open(path); }
+		~MappedFile() { close(); }
+
+		MappedFile(MappedFile const&) = delete;
+		MappedFile& operator=(MappedFile const&) = delete;
+
+		bool open(const std::string& path) {
+			close();
+#if _WIN32
+			_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (_file == INVALID_HANDLE_VALUE) return false;
+
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(_file, &size)) { close(); return false; }
+			_size = static_cast<std::size_t>(size.QuadPart);
+			_open = true;
+			if (_size == 0) return true;
+
+			_mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (_mapping == nullptr) { close(); return false; }
+			_data = static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+			if (_data == nullptr) { close(); return false; }
+#else
+			_fd = ::open(path.c_str(), O_RDONLY);
+			if (_fd < 0) return false;
+
+			struct stat st;
+			if (fstat(_fd, &st) != 0) { close(); return false; }
+			_size = static_cast<std::size_t>(st.st_size);
+			_open = true;
+			if (_size == 0) return true;
+
+			void* p = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+			if (p == MAP_FAILED) { close(); return false; }
+			_data = static_cast<const char*>(p);
+#endif
+			return true;
+		}
+
+		void close() {
+#if _WIN32
+			if (_data != nullptr) UnmapViewOfFile(_data);
+			if (_mapping != nullptr) CloseHandle(_mapping);
+			if (_file != INVALID_HANDLE_VALUE) CloseHandle(_file);
+			_mapping = nullptr;
+			_file = INVALID_HANDLE_VALUE;
+#else
+			if (_data != nullptr) munmap(const_cast<char*>(_data), _size);
+			if (_fd >= 0) ::close(_fd);
+			_fd = -1;
+#endif
+			_data = nullptr;
+			_size = 0;
+			_open = false;
+		}
+
+		bool isOpen() const { return _open; }
+		const char* data() const { return _data; }
+		std::size_t size() const { return _size; }
+
+	private:
+		const char* _data = nullptr;
+		std::size_t _size = 0;
+		bool _open = false;
+#if _WIN32
+		HANDLE _file = INVALID_HANDLE_VALUE;
+		HANDLE _mapping = nullptr;
+#else
+		int _fd = -1;
+#endif
+	};
+
+}
@@ -0,0 +1,318 @@
+#pragma once
+
+
+#include "cebnf_search.hpp"
+#include "cebnf_mmap.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+
+/*parallel search over many files (Searcher on every core)
+
+ParallelScanner(searcher, options).run(paths): each file is memory mapped by the worker that takes it.
+a file larger than chunk_size is split at newlines into chunks that idle workers steal, so one large log
+uses every core as well as 10k small files. a chunk reports the matches that start in it (they may run past
+its end); run() then joins the chunks as one left to right scan of the file: the matches of a chunk that
+start inside a match of the previous chunk are removed, and the gap up to the next match of the chunk is
+searched again. the result does not depend on chunk_size.
+tasks: one deque per worker, the owner takes from the back, the others steal from the front.
+
+scanMain(argc, argv, rule): command line tool of a rule (frijson_scan.cpp).
+*/
+namespace cebnf {
+
+	struct ScanOptions {
+		std::size_t threads = 0;            /*0: std::thread::hardware_concurrency()*/
+		std::size_t chunk_size = 1 << 22;   /*bytes per task of a large file*/
+		bool split = true;                  /*split large files at newlines*/
+		bool count_tokens = false;          /*build the trees and count the nodes per token id (instead of spans)*/
+	};
+
+	struct ScanResult {
+		std::string path;
+		bool ok = false;                                           /*file opened*/
+		std::size_t matches = 0;
+		std::vector<std::pair<std::size_t, std::size_t>> spans;    /*(begin, length), !count_tokens (internally also for count_tokens)*/
+		std::map<std::size_t, std::size_t> token_counts;           /*token id -> nodes, count_tokens*/
+	};
+
+	class ParallelScanner {
+	public:
+		ParallelScanner(const Searcher& searcher, const ScanOptions& options = ScanOptions()) : _searcher(searcher), _options(options) {
+			if (_options.threads == 0) _options.threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+			if (_options.chunk_size == 0) _options.chunk_size = 1;
+		}
+
+		/*results in the order of paths*/
+		std::vector<ScanResult> run(const std::vector<std::string>& paths) {
+			_files.assign(paths.size(), FileState());
+			for (std::size_t i = 0; i < paths.size(); ++i) _files[i].result.path = paths[i];
+
+			_queues.clear();
+			for (std::size_t t = 0; t < _options.threads; ++t) _queues.emplace_back(new TaskQueue());
+			for (std::size_t i = 0; i < paths.size(); ++i) _queues[i % _options.threads]->tasks.push_back(Task{ i, 0, 0, 0, nullptr });
+			_pending = paths.size();
+
+			std::vector<std::thread> workers;
+			for (std::size_t t = 1; t < _options.threads; ++t) workers.emplace_back(&ParallelScanner::work, this, t);
+			work(0);
+			for (auto& w : workers) w.join();
+
+			std::vector<ScanResult> res;
+			res.reserve(_files.size());
+			for (auto& f : _files) {
+				join(f);
+				if (_options.count_tokens) f.result.spans.clear();
+				res.push_back(std::move(f.result));
+			}
+			_files.clear();
+			return res;
+		}
+
+	private:
+		/*whole file (map == nullptr) or chunk [begin, end) of a mapped file*/
+		struct Task {
+			std::size_t file;
+			std::size_t chunk;
+			std::size_t begin;
+			std::size_t end;
+			std::shared_ptr<MappedFile> map;
+		};
+
+		struct TaskQueue {
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		struct Chunk {
+			std::pair<std::size_t, std::size_t> range; /*[begin, end) of the match starts*/
+			ScanResult result;
+		};
+
+		struct FileState {
+			ScanResult result;
+			std::vector<Chunk> chunks;          /*partial results, one per chunk*/
+			std::shared_ptr<MappedFile> map;    /*kept for join*/
+		};
+
+		void work(std::size_t self) {
+			Task task;
+			while (_pending.load() != 0) {
+				if (!pop(self, task) && !steal(self, task)) {
+					std::this_thread::yield();
+					continue;
+				}
+				if (task.map == nullptr) {
+					open(self, task.file);
+				}
+				else {
+					scan(task.map->data(), task.map->size(), task.begin, task.end, _files[task.file].chunks[task.chunk].result);
+				}
+				--_pending;
+			}
+		}
+
+		bool pop(std::size_t self, Task& task) {
+			TaskQueue& q = *_queues[self];
+			std::lock_guard<std::mutex> lock(q.mutex);
+			if (q.tasks.empty()) return false;
+			task = std::move(q.tasks.back());
+			q.tasks.pop_back();
+			return true;
+		}
+
+		bool steal(std::size_t self, Task& task) {
+			for (std::size_t k = 1; k < _queues.size(); ++k) {
+				TaskQueue& q = *_queues[(self + k) % _queues.size()];
+				std::lock_guard<std::mutex> lock(q.mutex);
+				if (q.tasks.empty()) continue;
+				task = std::move(q.tasks.front());
+				q.tasks.pop_front();
+				return true;
+			}
+			return false;
+		}
+
+		/*map the file: scan it, or push its chunks (cut after a newline) to the own queue*/
+		void open(std::size_t self, std::size_t file) {
+			FileState& f = _files[file];
+			std::shared_ptr<MappedFile> map(new MappedFile());
+			f.result.ok = map->open(f.result.path);
+			if (!f.result.ok || map->size() == 0) {
+				return;
+			}
+
+			const char* p = map->data();
+			const std::size_t n = map->size();
+			std::vector<std::pair<std::size_t, std::size_t>> ranges;
+			std::size_t begin = 0;
+			while (begin < n) {
+				std::size_t end = n;
+				if (_options.split && n - begin > _options.chunk_size) {
+					const void* nl = std::memchr(p + begin + _options.chunk_size, '\n', n - begin - _options.chunk_size);
+					if (nl != nullptr) end = static_cast<std::size_t>(static_cast<const char*>(nl) - p) + 1;
+				}
+				ranges.emplace_back(begin, end);
+				begin = end;
+			}
+
+			f.map = map;
+			f.chunks.resize(ranges.size());
+			for (std::size_t c = 0; c < ranges.size(); ++c) f.chunks[c].range = ranges[c];
+			if (ranges.size() == 1) {
+				scan(p, n, 0, n, f.chunks[0].result);
+				return;
+			}
+
+			_pending += ranges.size();
+			TaskQueue& q = *_queues[self];
+			std::lock_guard<std::mutex> lock(q.mutex);
+			for (std::size_t c = 0; c < ranges.size(); ++c) q.tasks.push_back(Task{ file, c, ranges[c].first, ranges[c].second, map });
+		}
+
+		/*matches that start in [begin, end) of the file [p, p + n)*/
+		void scan(const char* p, std::size_t n, std::size_t begin, std::size_t end, ScanResult& res) const {
+			if (!_options.count_tokens) {
+				res.matches = _searcher.forEach(p, n, begin, end, [&res](std::size_t b, std::size_t len) { res.spans.emplace_back(b, len); });
+				return;
+			}
+
+			res.matches = _searcher.forEachTree(p, n, begin, end, [&res](std::size_t b, std::size_t len, std::unique_ptr<SyntaxNode>&& node) {
+				res.spans.emplace_back(b, len);
+				count(node.get(), res.token_counts, true);
+			});
+		}
+
+		/*chunk results -> the result of one scan of the file
+		pos: position of the sequential scan. the matches of a chunk before pos are removed, and if pos is inside
+		a removed match, the starts from pos up to its end (the next position the chunk scan tried) are searched again*/
+		void join(FileState& f) const {
+			const char* p = f.map != nullptr ? f.map->data() : nullptr;
+			const std::size_t n = f.map != nullptr ? f.map->size() : 0;
+			std::size_t pos = 0;
+			for (auto& chunk : f.chunks) {
+				const std::size_t end = chunk.range.second;
+				ScanResult& c = chunk.result;
+				std::size_t i = 0;
+				pos = std::max(pos, chunk.range.first);
+				while (true) {
+					std::size_t cover = pos;
+					for (; i < c.spans.size() && c.spans[i].first < pos; ++i) {
+						cover = std::max(cover, c.spans[i].first + c.spans[i].second);
+						if (_options.count_tokens) {
+							_searcher.forEachTree(p, n, c.spans[i].first, c.spans[i].first + 1, [&c](std::size_t, std::size_t, std::unique_ptr<SyntaxNode>&& node) { count(node.get(), c.token_counts, false); });
+						}
+						--c.matches;
+					}
+					if (cover == pos) break;
+
+					const std::size_t to = std::min(cover, end);
+					ScanResult gap;
+					scan(p, n, pos, to, gap);
+					pos = std::max(pos, to);
+					if (!gap.spans.empty()) pos = std::max(pos, gap.spans.back().first + gap.spans.back().second);
+					add(f.result, gap);
+				}
+				c.spans.erase(c.spans.begin(), c.spans.begin() + i);
+				if (!c.spans.empty()) pos = std::max(pos, c.spans.back().first + c.spans.back().second);
+				pos = std::max(pos, end);
+				add(f.result, c);
+			}
+			for (auto itr = f.result.token_counts.begin(); itr != f.result.token_counts.end();) {
+				itr = itr->second == 0 ? f.result.token_counts.erase(itr) : std::next(itr);
+			}
+			f.map.reset();
+		}
+
+		static void add(ScanResult& dst, const ScanResult& src) {
+			dst.matches += src.matches;
+			dst.spans.insert(dst.spans.end(), src.spans.begin(), src.spans.end());
+			for (const auto& kv : src.token_counts) dst.token_counts[kv.first] += kv.second;
+		}
+
+		/*nodes per token id of a match tree, added or removed*/
+		static void count(const SyntaxNode* root, std::map<std::size_t, std::size_t>& counts, bool add) {
+			std::vector<const SyntaxNode*> stack(1, root);
+			while (!stack.empty()) {
+				const SyntaxNode* n = stack.back();
+				stack.pop_back();
+				if (add) ++counts[n->getTokenID()];
+				else --counts[n->getTokenID()];
+				for (const auto& c : n->children) stack.push_back(c.get());
+			}
+		}
+
+		const Searcher& _searcher;
+		ScanOptions _options;
+		std::vector<FileState> _files;
+		std::vector<std::unique_ptr<TaskQueue>> _queues;
+		std::atomic<std::size_t> _pending{ 0 };
+	};
+
+	/*usage: <tool> [-j threads] [-s chunk bytes] [-c] [-w] [files...] (no files: paths from stdin, one per line)
+	-c: per token counts of the match trees, -w: do not split large files.
+	output: path:begin:length per match, or token_id count per token (all files)*/
+	inline int scanMain(int argc, char* argv[], const Rule& rule) {
+		/*value of -j / -s: digits only*/
+		auto number = [argc, argv](int i, std::size_t& v) {
+			if (i >= argc || *argv[i] < '0' || *argv[i] > '9') return false;
+			char* end = nullptr;
+			errno = 0;
+			const unsigned long long n = std::strtoull(argv[i], &end, 10);
+			v = static_cast<std::size_t>(n);
+			return *end == '\0' && errno == 0 && n <= std::numeric_limits<std::size_t>::max();
+		};
+
+		ScanOptions options;
+		std::vector<std::string> paths;
+		for (int i = 1; i < argc; ++i) {
+			const std::string a = argv[i];
+			if (a == "-j" || a == "-s") {
+				if (!number(++i, a == "-j" ? options.threads : options.chunk_size)) {
+					std::cerr << "usage: " << argv[0] << " [-j threads] [-s chunk bytes] [-c] [-w] [files...]" << std::endl;
+					return 1;
+				}
+			}
+			else if (a == "-c") options.count_tokens = true;
+			else if (a == "-w") options.split = false;
+			else paths.push_back(a);
+		}
+		if (paths.empty()) {
+			std::string line;
+			while (std::getline(std::cin, line)) {
+				if (!line.empty()) paths.push_back(line);
+			}
+		}
+
+		const Searcher searcher(rule);
+		const std::vector<ScanResult> results = ParallelScanner(searcher, options).run(paths);
+
+		int status = 0;
+		std::map<std::size_t, std::size_t> counts;
+		std::size_t matches = 0;
+		for (const auto& r : results) {
+			if (!r.ok) {
+				std::cerr << "Error: cannot open " << r.path << std::endl;
+				status = 1;
+				continue;
+			}
+			matches += r.matches;
+			for (const auto& s : r.spans) std::cout << r.path << ':' << s.first << ':' << s.second << '\n';
+			for (const auto& kv : r.token_counts) counts[kv.first] += kv.second;
+		}
+		if (options.count_tokens) {
+			for (const auto& kv : counts) std::cout << kv.first << ' ' << kv.second << '\n';
+		}
+		std::cerr << matches << " matches in " << results.size() << " files" << std::endl;
+		return status;
+	}
+
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+
+#include "cebnf.hpp"
+#include "cebnf_grammar.hpp"
+#include "cebnf_helper.hpp"
+
+#include <cstring>
+
+/*search mode: every match of a rule inside a text (like a regex scan)
+
+Searcher(rule).findAll(text): non-overlapping, non-empty matches from left to right.
+at each start the match is the one parse_impl finds (longest alternative), the scan continues after it.
+positions where no match can start are skipped by the FIRST set of the rule (GrammarInfo):
+one byte -> memchr, a few ranges -> CharSet span of the complement (16/32 bytes at a time).
+the skipper of the rule runs between elements as in parse(), not before a match.
+
+example (records embedded in a log):
+	Searcher search(record);
+	for (auto& node : search.findAll(log)) use(node->getBegin(), node->getString());
+*/
+namespace cebnf {
+
+	class Searcher {
+	public:
+		explicit Searcher(const Rule& rule) : Searcher(rule, GrammarInfo(rule)) {}
+
+		/*FIRST of rule from a prepared analysis (GrammarImage::info()): a grammar that contains rule, with the skipper of rule or none*/
+		Searcher(const Rule& rule, const GrammarInfo& info) : _rule(&rule), _skipper(rule.getSkipper()), _token_id(rule.getTokenID()) {
+			const std::size_t k = info.ruleIndex(&rule);
+			const GrammarInfo::ByteSet first = k == no_match ? GrammarInfo::ByteSet().set() : info.rules()[k].first;
+
+			_count = first.count();
+			for (std::size_t c = 0; c < 256; ++c) {
+				if (!first.test(c)) continue;
+				_bits[c >> 6] |= std::uint64_t(1) << (c & 63);
+				_byte = static_cast<char>(c);
+			}
+			_skip = CharSet(_bits).invert();
+		}
+
+		/*syntax trees of the matches (node of the rule, positions in text)*/
+		std::vector<std::unique_ptr<SyntaxNode>> findAll(const std::string& text) const {
+			std::vector<std::unique_ptr<SyntaxNode>> res;
+			forEachTree(text.data(), text.size(), [&res](std::unique_ptr<SyntaxNode>&& node) { res.push_back(std::move(node)); });
+			return res;
+		}
+
+		/*analysis mode: (begin, length) of the matches, no nodes*/
+		std::vector<std::pair<std::size_t, std::size_t>> findSpans(const std::string& text) const {
+			std::vector<std::pair<std::size_t, std::size_t>> res;
+			forEach(text.data(), text.size(), [&res](std::size_t begin, std::size_t length) { res.emplace_back(begin, length); });
+			return res;
+		}
+
+		/*f(begin, length) for each match of [p, p + n) in analysis mode. returns the number of matches*/
+		template<class F>
+		std::size_t forEach(const char* p, std::size_t n, F&& f) const {
+			return forEach(p, n, 0, n, std::forward<F>(f));
+		}
+
+		/*matches that start in [from, to) (a match may run past to, positions in p). returns the number of matches*/
+		template<class F>
+		std::size_t forEach(const char* p, std::size_t n, std::size_t from, std::size_t to, F&& f) const {
+			const InputSegments text(p, n);
+			const Input in(text, _skipper);
+			std::size_t count = 0;
+			for (std::size_t pos = next(p, to, from); pos < to; pos = next(p, to, pos)) {
+				const std::size_t len = _rule->match_impl(in, pos);
+				if (len == no_match || len == 0) {
+					++pos;
+					continue;
+				}
+				f(pos, len);
+				++count;
+				pos += len;
+			}
+			return count;
+		}
+
+		/*f(std::unique_ptr<SyntaxNode>&&) for each match of [p, p + n). returns the number of matches*/
+		template<class F>
+		std::size_t forEachTree(const char* p, std::size_t n, F&& f) const {
+			return forEachTree(p, n, 0, n, [&f](std::size_t, std::size_t, std::unique_ptr<SyntaxNode>&& node) { f(std::move(node)); });
+		}
+
+		/*f(begin, length, std::unique_ptr<SyntaxNode>&&) for each match that starts in [from, to). returns the number of matches*/
+		template<class F>
+		std::size_t forEachTree(const char* p, std::size_t n, std::size_t from, std::size_t to, F&& f) const {
+			const InputSegments text(p, n);
+			const Input in(text, _skipper);
+			std::size_t count = 0;
+			for (std::size_t pos = next(p, to, from); pos < to; pos = next(p, to, pos)) {
+				SyntaxTree&& tree = _rule->parse_impl(in, pos);
+				if (Tree::Failed(tree) || tree.second == 0) {
+					++pos;
+					continue;
+				}
+				const std::size_t len = tree.second;
+				f(pos, len, node(in, pos, std::move(tree)));
+				++count;
+				pos += len;
+			}
+			return count;
+		}
+
+		/*first position from pos where a match can start (n: none)*/
+		std::size_t next(const char* p, std::size_t n, std::size_t pos) const {
+			if (pos >= n || _count == 256) {
+				return pos;
+			}
+			if (_count == 0) {
+				return n;
+			}
+			if (_count == 1) {
+				const void* hit = std::memchr(p + pos, static_cast<unsigned char>(_byte), n - pos);
+				return hit != nullptr ? static_cast<std::size_t>(static_cast<const char*>(hit) - p) : n;
+			}
+			return pos + _skip.span(p + pos, n - pos);
+		}
+
+	private:
+		/*one node per match as parse() (a rule with shape_collapse / shape_omit returns its children)*/
+		std::unique_ptr<SyntaxNode> node(const Input& in, std::size_t pos, SyntaxTree&& tree) const {
+			if (tree.first.size() == 1 && !Tree::IsEpsilon(tree)) {
+				return std::move(tree.first[0]);
+			}
+			std::unique_ptr<SyntaxNode> res(new SyntaxNode(_token_id, in.substr(pos, tree.second), pos, tree.second));
+			if (!Tree::IsEpsilon(tree)) {
+				res->mergeChildren(std::move(tree.first));
+			}
+			return res;
+		}
+
+		const CEBNFBase* _rule;
+		const CEBNFBase* _skipper;
+		std::size_t _token_id;
+		std::array<std::uint64_t, 4> _bits = {}; /*FIRST*/
+		std::size_t _count = 0;                  /*bytes in FIRST*/
+		char _byte = 0;                          /*the byte of FIRST (_count == 1)*/
+		CharSet _skip;                           /*bytes outside FIRST*/
+	};
+
+}
@@ -0,0 +1,302 @@
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+
+/*SIMD scanning helpers for cebnf primitives
+
+Vector paths are selected at compile time: AVX2 (-mavx2, /arch:AVX2) > SSE2 (x86-64 default) > scalar.
+Define CEBNF_NO_SIMD to force the scalar paths.
+Every function works on [p, p + n) and never reads past p + n.
+*/
+
+#if !defined(CEBNF_NO_SIMD)
+#if defined(__AVX2__)
+#define CEBNF_SIMD_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CEBNF_SIMD_SSE2
+#endif
+#endif
+
+#if defined(CEBNF_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(CEBNF_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace cebnf {
+namespace simd {
+
+	inline unsigned int countTrailingZeros(std::uint32_t x) {
+#if defined(_MSC_VER)
+		unsigned long idx;
+		_BitScanForward(&idx, x);
+		return static_cast<unsigned int>(idx);
+#else
+		return static_cast<unsigned int>(__builtin_ctz(x));
+#endif
+	}
+
+	/*byte class as a union of closed ranges [lo, hi]
+	- size < 0 means the class has too many ranges for the vector paths*/
+	struct ByteRanges {
+		static constexpr int max_ranges = 8;
+
+		unsigned char lo[max_ranges] = {};
+		unsigned char hi[max_ranges] = {};
+		int size = 0;
+
+		bool contains(unsigned char c) const {
+			for (int r = 0; r < size; ++r) {
+				if (static_cast<unsigned char>(c - lo[r]) <= static_cast<unsigned char>(hi[r] - lo[r])) return true;
+			}
+			return false;
+		}
+	};
+
+	/*length of the leading run of bytes inside ranges
+	- x in [lo, hi] <=> (int8)(x + 0x80 - lo) <= (int8)((hi - lo) ^ 0x80), one add and one signed compare per range*/
+	inline std::size_t spanRanges(const char* p, std::size_t n, const ByteRanges& r) {
+		std::size_t i = 0;
+
+#if defined(CEBNF_SIMD_AVX2)
+		if (n >= 32) {
+			__m256i bias[ByteRanges::max_ranges], limit[ByteRanges::max_ranges];
+			for (int k = 0; k < r.size; ++k) {
+				bias[k]  = _mm256_set1_epi8(static_cast<char>(0x80 - r.lo[k]));
+				limit[k] = _mm256_set1_epi8(static_cast<char>((r.hi[k] - r.lo[k]) ^ 0x80));
+			}
+
+			for (; i + 32 <= n; i += 32) {
+				const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+				/*outside: bytes outside every range*/
+				__m256i outside = _mm256_cmpeq_epi8(x, x);
+				for (int k = 0; k < r.size; ++k) {
+					outside = _mm256_and_si256(outside, _mm256_cmpgt_epi8(_mm256_add_epi8(x, bias[k]), limit[k]));
+				}
+				const std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(outside));
+				if (mask != 0) return i + countTrailingZeros(mask);
+			}
+		}
+#endif
+
+#if defined(CEBNF_SIMD_SSE2)
+		if (n - i >= 16) {
+			__m128i bias[ByteRanges::max_ranges], limit[ByteRanges::max_ranges];
+			for (int k = 0; k < r.size; ++k) {
+				bias[k]  = _mm_set1_epi8(static_cast<char>(0x80 - r.lo[k]));
+				limit[k] = _mm_set1_epi8(static_cast<char>((r.hi[k] - r.lo[k]) ^ 0x80));
+			}
+
+			for (; i + 16 <= n; i += 16) {
+				const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+				__m128i outside = _mm_cmpeq_epi8(x, x);
+				for (int k = 0; k < r.size; ++k) {
+					outside = _mm_and_si128(outside, _mm_cmpgt_epi8(_mm_add_epi8(x, bias[k]), limit[k]));
+				}
+				const std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(outside));
+				if (mask != 0) return i + countTrailingZeros(mask);
+			}
+		}
+#endif
+
+		for (; i < n; ++i) {
+			if (!r.contains(static_cast<unsigned char>(p[i]))) return i;
+		}
+		return n;
+	}
+
+	/*length of the leading run of ASCII bytes (< 0x80)*/
+	inline std::size_t asciiPrefix(const char* p, std::size_t n) {
+		std::size_t i = 0;
+
+#if defined(CEBNF_SIMD_AVX2)
+		for (; i + 32 <= n; i += 32) {
+			const std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i))));
+			if (mask != 0) return i + countTrailingZeros(mask);
+		}
+#endif
+
+#if defined(CEBNF_SIMD_SSE2)
+		for (; i + 16 <= n; i += 16) {
+			const std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i))));
+			if (mask != 0) return i + countTrailingZeros(mask);
+		}
+#endif
+
+		for (; i < n; ++i) {
+			if (static_cast<unsigned char>(p[i]) >= 0x80) return i;
+		}
+		return n;
+	}
+
+	/*index of the first byte equal to a, b or c (n if none)*/
+	inline std::size_t findFirstOf(const char* p, std::size_t n, char a, char b, char c) {
+		std::size_t i = 0;
+
+#if defined(CEBNF_SIMD_AVX2)
+		if (n >= 32) {
+			const __m256i va = _mm256_set1_epi8(a), vb = _mm256_set1_epi8(b), vc = _mm256_set1_epi8(c);
+			for (; i + 32 <= n; i += 32) {
+				const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+				const __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, va), _mm256_cmpeq_epi8(x, vb)), _mm256_cmpeq_epi8(x, vc));
+				const std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hit));
+				if (mask != 0) return i + countTrailingZeros(mask);
+			}
+		}
+#endif
+
+#if defined(CEBNF_SIMD_SSE2)
+		if (n - i >= 16) {
+			const __m128i va = _mm_set1_epi8(a), vb = _mm_set1_epi8(b), vc = _mm_set1_epi8(c);
+			for (; i + 16 <= n; i += 16) {
+				const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+				const __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, va), _mm_cmpeq_epi8(x, vb)), _mm_cmpeq_epi8(x, vc));
+				const std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(hit));
+				if (mask != 0) return i + countTrailingZeros(mask);
+			}
+		}
+#endif
+
+		for (; i < n; ++i) {
+			if (p[i] == a || p[i] == b || p[i] == c) return i;
+		}
+		return n;
+	}
+
+	/*append the index (+ offset) of every byte equal to c to out (push_back)*/
+	template<class Out>
+	inline void findAll(const char* p, std::size_t n, char c, std::size_t offset, Out& out) {
+		std::size_t i = 0;
+
+#if defined(CEBNF_SIMD_AVX2)
+		if (n >= 32) {
+			const __m256i vc = _mm256_set1_epi8(c);
+			for (; i + 32 <= n; i += 32) {
+				const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+				std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, vc)));
+				while (mask != 0) {
+					out.push_back(offset + i + countTrailingZeros(mask));
+					mask &= mask - 1;
+				}
+			}
+		}
+#endif
+
+#if defined(CEBNF_SIMD_SSE2)
+		if (n - i >= 16) {
+			const __m128i vc = _mm_set1_epi8(c);
+			for (; i + 16 <= n; i += 16) {
+				const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+				std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, vc)));
+				while (mask != 0) {
+					out.push_back(offset + i + countTrailingZeros(mask));
+					mask &= mask - 1;
+				}
+			}
+		}
+#endif
+
+		for (; i < n; ++i) {
+			if (p[i] == c) out.push_back(offset + i);
+		}
+	}
+
+#if defined(CEBNF_SIMD_AVX2)
+	/*UTF-8 validation, 32 bytes per step (Keiser & Lemire lookup: three nibble tables classify each byte pair,
+	a saturating subtract checks the 3rd/4th continuation bytes). The tail is checked in a zero padded block,
+	so a sequence cut at the end fails as "too short".*/
+	inline bool validateUTF8AVX2(const char* p, std::size_t n) {
+		constexpr char too_short = 1 << 0;      /*lead byte, then ASCII or lead*/
+		constexpr char too_long = 1 << 1;       /*ASCII, then continuation*/
+		constexpr char overlong_3 = 1 << 2;     /*11100000 100_____*/
+		constexpr char too_large = 1 << 3;      /*11110100 1001____ and above*/
+		constexpr char surrogate = 1 << 4;      /*11101101 101_____*/
+		constexpr char overlong_2 = 1 << 5;     /*1100000_ 10______*/
+		constexpr char too_large_1000 = 1 << 6; /*11110101+ 1000____*/
+		constexpr char overlong_4 = 1 << 6;     /*11110000 1000____*/
+		constexpr char two_conts = static_cast<char>(1 << 7); /*continuation, then continuation (unless 3rd/4th byte)*/
+		constexpr char carry = too_short | too_long | two_conts;
+
+		const __m256i byte_1_high = _mm256_setr_epi8(
+			too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+			two_conts, two_conts, two_conts, two_conts,
+			too_short | overlong_2, too_short, too_short | overlong_3 | surrogate, too_short | too_large | too_large_1000 | overlong_4,
+			too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+			two_conts, two_conts, two_conts, two_conts,
+			too_short | overlong_2, too_short, too_short | overlong_3 | surrogate, too_short | too_large | too_large_1000 | overlong_4);
+		const __m256i byte_1_low = _mm256_setr_epi8(
+			carry | overlong_3 | overlong_2 | overlong_4, carry | overlong_2, carry, carry,
+			carry | too_large, carry | too_large | too_large_1000, carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000, carry | too_large | too_large_1000, carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000, carry | too_large | too_large_1000 | surrogate, carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+			carry | overlong_3 | overlong_2 | overlong_4, carry | overlong_2, carry, carry,
+			carry | too_large, carry | too_large | too_large_1000, carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000, carry | too_large | too_large_1000, carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+			carry | too_large | too_large_1000, carry | too_large | too_large_1000 | surrogate, carry | too_large | too_large_1000, carry | too_large | too_large_1000);
+		const __m256i byte_2_high = _mm256_setr_epi8(
+			too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+			too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+			too_long | overlong_2 | two_conts | overlong_3 | too_large,
+			too_long | overlong_2 | two_conts | surrogate | too_large,
+			too_long | overlong_2 | two_conts | surrogate | too_large,
+			too_short, too_short, too_short, too_short,
+			too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+			too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+			too_long | overlong_2 | two_conts | overlong_3 | too_large,
+			too_long | overlong_2 | two_conts | surrogate | too_large,
+			too_long | overlong_2 | two_conts | surrogate | too_large,
+			too_short, too_short, too_short, too_short);
+
+		const __m256i nibble = _mm256_set1_epi8(0x0F);
+		const __m256i third = _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80));
+		const __m256i fourth = _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80));
+		const __m256i high_bit = _mm256_set1_epi8(static_cast<char>(0x80));
+
+		__m256i prev = _mm256_setzero_si256();
+		__m256i error = _mm256_setzero_si256();
+
+		auto check = [&](const __m256i x) {
+			/*bytes 1, 2, 3 back (across the previous block)*/
+			const __m256i carried = _mm256_permute2x128_si256(prev, x, 0x21);
+			const __m256i prev1 = _mm256_alignr_epi8(x, carried, 15);
+			const __m256i prev2 = _mm256_alignr_epi8(x, carried, 14);
+			const __m256i prev3 = _mm256_alignr_epi8(x, carried, 13);
+
+			const __m256i special = _mm256_and_si256(_mm256_and_si256(
+				_mm256_shuffle_epi8(byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+				_mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, nibble))),
+				_mm256_shuffle_epi8(byte_2_high, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble)));
+			const __m256i must23 = _mm256_and_si256(_mm256_or_si256(_mm256_subs_epu8(prev2, third), _mm256_subs_epu8(prev3, fourth)), high_bit);
+
+			error = _mm256_or_si256(error, _mm256_xor_si256(must23, special));
+			prev = x;
+		};
+
+		std::size_t i = 0;
+		for (; i + 32 <= n; i += 32) {
+			const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+			/*ASCII block: only an unfinished sequence in prev can fail*/
+			if (_mm256_movemask_epi8(x) == 0 && _mm256_movemask_epi8(prev) == 0) {
+				prev = x;
+				continue;
+			}
+			check(x);
+		}
+
+		alignas(32) char tail[32] = {};
+		for (std::size_t k = 0; i + k < n; ++k) tail[k] = p[i + k];
+		check(_mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+
+		return _mm256_testz_si256(error, error) != 0;
+	}
+#endif
+
+}
+}
@@ -3,35 +3,209 @@
 
 #include "cebnf.hpp"
 
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+
+#if _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/*syntax tree writer
+print() returns the tree as one string, write*() stream it (iterative: no recursion, no string concatenation per level).
+
+text  :: <string> :: <token id>, children indented by "|   "
+JSON  :: {"id":<token id>,"s":"<string>","c":[<children>]}
+dot   :: Graphviz digraph
+*/
+struct PrintSyntaxTreeOptions {
+	/*indentation per depth (text)*/
+	std::string indent = "|   ";
+	/*nodes deeper than max_depth are not written (root is depth 0)*/
+	std::size_t max_depth = static_cast<std::size_t>(-1);
+	/*strings longer than max_length are cut and end with "..."*/
+	std::size_t max_length = static_cast<std::size_t>(-1);
+};
+
 class PrintSyntaxTree {
 public:
 
-	static std::string print(const std::unique_ptr<cebnf::SyntaxNode>& root) {
-		std::string res = root->getString() + std::string(" :: ") + std::to_string(root->getTokenID()) + std::string("\n");
+	using Options = PrintSyntaxTreeOptions;
 
-		for (int i = 0; i < root->children.size(); ++i) {
-			res += print_impl(root->children[i], 1);
-		}
+	static std::string print(const std::unique_ptr<cebnf::SyntaxNode>& root, const Options& opt = Options()) {
+		std::ostringstream os;
+		write(os, root, opt);
+		return os.str();
+	}
+
+	static void write(std::ostream& os, const std::unique_ptr<cebnf::SyntaxNode>& root, const Options& opt = Options()) {
+		walk(*root, opt.max_depth,
+			[&](const cebnf::SyntaxNode& node, std::size_t depth, std::size_t /*index*/) {
+				for (std::size_t i = 0; i < depth; ++i) os << opt.indent;
+				writeString(os, node.getString(), opt.max_length);
+				os << " :: " << node.getTokenID() << '\n';
+			},
+			[&](const cebnf::SyntaxNode& /*node*/, std::size_t /*depth*/) {},
+			[&](std::size_t depth) {
+				for (std::size_t i = 0; i < depth; ++i) os << opt.indent;
+				os << "...\n";
+			});
+	}
+
+	/*write to a file descriptor (buffered)*/
+	static void write(int fd, const std::unique_ptr<cebnf::SyntaxNode>& root, const Options& opt = Options()) {
+		FdStreamBuf buf(fd);
+		std::ostream os(&buf);
+		write(os, root, opt);
+		os.flush();
+	}
+
+	static void writeJSON(std::ostream& os, const std::unique_ptr<cebnf::SyntaxNode>& root, const Options& opt = Options()) {
+		walk(*root, opt.max_depth,
+			[&](const cebnf::SyntaxNode& node, std::size_t /*depth*/, std::size_t index) {
+				if (index > 0) os << ',';
+				os << "{\"id\":" << node.getTokenID() << ",\"s\":\"";
+				writeEscaped(os, node.getString(), opt.max_length);
+				os << "\",\"c\":[";
+			},
+			[&](const cebnf::SyntaxNode& /*node*/, std::size_t /*depth*/) {
+				os << "]}";
+			},
+			[&](std::size_t /*depth*/) {});
+		os << '\n';
+	}
+
+	static void writeDot(std::ostream& os, const std::unique_ptr<cebnf::SyntaxNode>& root, const Options& opt = Options()) {
+		std::size_t next_id = 0;
+		std::vector<std::size_t> ids;
 
-		return res;
+		os << "digraph SyntaxTree {\n\tnode [shape=box];\n";
+		walk(*root, opt.max_depth,
+			[&](const cebnf::SyntaxNode& node, std::size_t depth, std::size_t /*index*/) {
+				const std::size_t id = next_id++;
+				ids.resize(depth);
+				os << "\tn" << id << " [label=\"" << node.getTokenID() << ": ";
+				writeEscaped(os, node.getString(), opt.max_length, true);
+				os << "\"];\n";
+				if (depth > 0) os << "\tn" << ids[depth - 1] << " -> n" << id << ";\n";
+				ids.push_back(id);
+			},
+			[&](const cebnf::SyntaxNode& /*node*/, std::size_t /*depth*/) {},
+			[&](std::size_t /*depth*/) {});
+		os << "}\n";
 	}
 
 private:
 
-	static std::string print_impl(const std::unique_ptr<cebnf::SyntaxNode>& node, unsigned int depth) {
-		std::string res;
-		for (int i = 0; i < depth; ++i) res += "|   ";
+	/*preorder DFS with an explicit stack
+	enter(node, depth, index in parent), leave(node, depth), cut(depth): children deeper than max_depth were skipped*/
+	template<class Enter, class Leave, class Cut>
+	static void walk(const cebnf::SyntaxNode& root, std::size_t max_depth, Enter enter, Leave leave, Cut cut) {
+		std::vector<std::pair<const cebnf::SyntaxNode*, std::size_t>> stack;
 
-		res += node->getString() + std::string(" :: ") + std::to_string(node->getTokenID()) + std::string("\n");
+		enter(root, 0, 0);
+		stack.emplace_back(&root, 0);
 
-		for (int i = 0; i < node->children.size(); ++i) {
-			res += print_impl(node->children[i], depth + 1);
+		while (!stack.empty()) {
+			const cebnf::SyntaxNode* node = stack.back().first;
+			const std::size_t i = stack.back().second++;
+			const std::size_t depth = stack.size();
+
+			if (i < node->children.size() && depth > max_depth) {
+				cut(depth);
+				stack.back().second = node->children.size();
+			}
+			else if (i < node->children.size()) {
+				const cebnf::SyntaxNode* child = node->children[i].get();
+				enter(*child, depth, i);
+				stack.emplace_back(child, 0);
+			}
+			else {
+				leave(*node, depth - 1);
+				stack.pop_back();
+			}
 		}
+	}
 
-		return res;
+	/*bytes written of s: at most max_length, not inside a UTF-8 sequence*/
+	static std::size_t cutLength(const std::string& s, std::size_t max_length) {
+		if (s.length() <= max_length) {
+			return s.length();
+		}
+		std::size_t n = max_length;
+		while (n > 0 && (static_cast<unsigned char>(s[n]) & 0xC0) == 0x80) --n;
+		return n;
+	}
+
+	static void writeString(std::ostream& os, const std::string& s, std::size_t max_length) {
+		const std::size_t n = cutLength(s, max_length);
+		os.write(s.data(), n);
+		if (n < s.length()) os << "...";
 	}
 
+	/*JSON string escape (control bytes \u00XX), dot: control bytes and & as HTML entities (&#xXX;, dot has no \u)*/
+	static void writeEscaped(std::ostream& os, const std::string& s, std::size_t max_length, bool dot = false) {
+		static const char hex[] = "0123456789abcdef";
+		const std::size_t n = cutLength(s, max_length);
 
-};
+		for (std::size_t i = 0; i < n; ++i) {
+			const unsigned char c = static_cast<unsigned char>(s[i]);
+			if (c == '"' || c == '\\') {
+				os << '\\' << c;
+			}
+			else if (dot && (c < 0x20 || c == '&')) {
+				os << "&#x" << hex[c >> 4] << hex[c & 15] << ';';
+			}
+			else if (c < 0x20) {
+				os << "\\u00" << hex[c >> 4] << hex[c & 15];
+			}
+			else {
+				os << c;
+			}
+		}
+		if (n < s.length()) os << "...";
+	}
 
+	class FdStreamBuf : public std::streambuf {
+	public:
+		FdStreamBuf(int fd) : _fd(fd) {
+			setp(_buf, _buf + sizeof(_buf));
+		}
+		~FdStreamBuf() {
+			sync();
+		}
+
+	protected:
+		virtual int_type overflow(int_type c) override {
+			if (sync() != 0) return traits_type::eof();
+			if (!traits_type::eq_int_type(c, traits_type::eof())) {
+				*pptr() = traits_type::to_char_type(c);
+				pbump(1);
+			}
+			return traits_type::not_eof(c);
+		}
+
+		virtual int sync() override {
+			const char* p = pbase();
+			while (p < pptr()) {
+#if _WIN32
+				const long n = _write(_fd, p, static_cast<unsigned int>(pptr() - p));
+#else
+				const long n = ::write(_fd, p, static_cast<std::size_t>(pptr() - p));
+#endif
+				if (n <= 0) return -1;
+				p += n;
+			}
+			setp(_buf, _buf + sizeof(_buf));
+			return 0;
+		}
+
+	private:
+		int _fd;
+		char _buf[1 << 16];
+	};
+
+};
 
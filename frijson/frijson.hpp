@@ -62,6 +62,12 @@ namespace frijson {
 	public:
 		virtual bool getBool() const { return false; }
 
+		/*parsed numeric value (set by Parser)*/
+		virtual bool hasNumber() const { return false; }
+		virtual bool isInteger() const { return false; }
+		virtual long long getInteger() const { return 0; }
+		virtual double getReal() const { return 0.0; }
+
 		virtual String& getStr() { return FRIJSON_NULL_STRING; }
 		virtual Object& getObj() { return FRIJSON_NULL_OBJECT; }
 		virtual Array&  getArr() { return FRIJSON_NULL_ARRAY; }
@@ -99,11 +105,22 @@ namespace frijson {
 	public:
 		JsonNumber(String& e) : value(e) {}
 		JsonNumber(const String& e) : value(e) {}
+		JsonNumber(const String& e, long long i) : value(e), has_number(true), is_integer(true), integer(i), real(static_cast<double>(i)) {}
+		JsonNumber(const String& e, double d) : value(e), has_number(true), real(d) {}
 		virtual String& getStr() override { return value; }
 		virtual const String& getStr() const override { return value; }
 
+		virtual bool hasNumber() const override { return has_number; }
+		virtual bool isInteger() const override { return is_integer; }
+		virtual long long getInteger() const override { return integer; }
+		virtual double getReal() const override { return real; }
+
 	private:
 		String value;
+		bool has_number = false;
+		bool is_integer = false;
+		long long integer = 0;
+		double real = 0.0;
 	};
 
 	class JsonObject : public JsonBase {
@@ -187,17 +204,17 @@ namespace frijson {
 		template<class NumericType>
 		NumericType numeric() const;
 
-		template<> char					numeric<char				>() const { return (char)std::stoi(_dat->getStr());			}
-		template<> unsigned char		numeric<unsigned char		>() const { return (unsigned char)std::stoi(_dat->getStr());}
-		template<> float				numeric<float				>() const { return std::stof(_dat->getStr());				}
-		template<> double				numeric<double				>() const { return std::stod(_dat->getStr());				}
-		template<> long double			numeric<long double			>() const { return std::stold(_dat->getStr());				}
-		template<> int					numeric<int					>() const { return std::stoi(_dat->getStr());				}
-		template<> unsigned int			numeric<unsigned int		>() const { return (unsigned int)std::stoul(_dat->getStr());}
-		template<> long					numeric<long				>() const { return std::stol(_dat->getStr());				}
-		template<> long long			numeric<long long			>() const { return std::stoll(_dat->getStr());				}
-		template<> unsigned long		numeric<unsigned long		>() const { return std::stoul(_dat->getStr());				}
-		template<> unsigned long long	numeric<unsigned long long	>() const { return std::stoull(_dat->getStr());				}
+		template<> char					numeric<char				>() const { return _dat->isInteger() ? (char)_dat->getInteger()					: (char)std::stoi(_dat->getStr());			}
+		template<> unsigned char		numeric<unsigned char		>() const { return _dat->isInteger() ? (unsigned char)_dat->getInteger()			: (unsigned char)std::stoi(_dat->getStr());}
+		template<> float				numeric<float				>() const { return _dat->hasNumber() ? (float)_dat->getReal()						: std::stof(_dat->getStr());				}
+		template<> double				numeric<double				>() const { return _dat->hasNumber() ? _dat->getReal()								: std::stod(_dat->getStr());				}
+		template<> long double			numeric<long double			>() const { return std::stold(_dat->getStr());																}
+		template<> int					numeric<int					>() const { return _dat->isInteger() ? (int)_dat->getInteger()						: std::stoi(_dat->getStr());				}
+		template<> unsigned int			numeric<unsigned int		>() const { return _dat->isInteger() ? (unsigned int)_dat->getInteger()				: (unsigned int)std::stoul(_dat->getStr());}
+		template<> long					numeric<long				>() const { return _dat->isInteger() ? (long)_dat->getInteger()						: std::stol(_dat->getStr());				}
+		template<> long long			numeric<long long			>() const { return _dat->isInteger() ? _dat->getInteger()							: std::stoll(_dat->getStr());				}
+		template<> unsigned long		numeric<unsigned long		>() const { return _dat->isInteger() ? (unsigned long)_dat->getInteger()			: std::stoul(_dat->getStr());				}
+		template<> unsigned long long	numeric<unsigned long long	>() const { return _dat->isInteger() ? (unsigned long long)_dat->getInteger()		: std::stoull(_dat->getStr());				}
 		//*/
 		
 		/*find object key*/
@@ -415,6 +432,13 @@ namespace frijson {
 		static Json createNumeric(const char* num) {
 			return Json(Json::ValueType::eNumeric, new JsonNumber(String(num)));
 		}
+		/*numeric text with its parsed value*/
+		static Json createNumeric(const String& num, long long value) {
+			return Json(Json::ValueType::eNumeric, new JsonNumber(num, value));
+		}
+		static Json createNumeric(const String& num, double value) {
+			return Json(Json::ValueType::eNumeric, new JsonNumber(num, value));
+		}
 
 
 		static Json createObject() {
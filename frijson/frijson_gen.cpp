@@ -0,0 +1,31 @@
+/*generates frijson_generated.hpp from JsonGrammar (frijson_grammar.hpp)
+usage: frijson_gen <output header>*/
+#include "frijson_grammar.hpp"
+#include "../cebnf/cebnf_codegen.hpp"
+
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		std::cerr << "usage: " << argv[0] << " <output header>" << std::endl;
+		return 1;
+	}
+
+	const frijson::JsonGrammar grammar;
+	cebnf::CodeGenerator gen(grammar._jbase, { "frijson_generated", "../cebnf/", "frijson_grammar.hpp (frijson_gen.cpp)" });
+
+	std::string code;
+	if (!gen.generate(code)) {
+		std::cerr << "Error: " << gen.error() << std::endl;
+		return 1;
+	}
+
+	std::ofstream ofs(argv[1], std::ios::binary);
+	ofs << code;
+	if (!ofs) {
+		std::cerr << "Error: cannot write " << argv[1] << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,882 @@
+#pragma once
+
+/*generated by cebnf::CodeGenerator from frijson_grammar.hpp (frijson_gen.cpp). do not edit.*/
+
+#include "../cebnf/cebnf.hpp"
+#include "../cebnf/cebnf_helper.hpp"
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace frijson_generated {
+
+	namespace detail {
+
+		struct Ctx {
+			const std::string* str;
+			const char* p;
+			std::size_t n;
+			const cebnf::Input* raw; /*input of the helper tokens*/
+			bool skip;
+		};
+
+		inline Ctx noSkip(const Ctx& c) {
+			Ctx res = c;
+			res.skip = false;
+			return res;
+		}
+
+		inline std::size_t skip(const Ctx& c, std::size_t pos);
+		inline cebnf::SyntaxTree e0_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e0_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e1_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e1_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e2_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e2_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e3_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e3_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e4_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e4_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e5_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e5_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e6_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e6_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e7_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e7_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e8_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e8_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e9_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e9_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e10_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e10_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree r0_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t r0_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e11_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e11_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e12_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e12_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e13_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e13_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e14_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e14_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e15_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e15_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e16_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e16_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e17_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e17_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e18_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e18_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e19_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e19_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e20_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e20_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e21_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e21_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e22_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e22_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e23_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e23_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e24_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e24_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e25_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e25_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e26_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e26_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e27_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e27_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e28_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e28_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e29_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e29_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree r5_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t r5_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e30_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e30_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e31_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e31_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e32_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e32_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e33_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e33_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e34_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e34_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e35_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e35_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e36_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e36_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e37_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e37_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e38_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e38_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e39_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e39_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e40_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e40_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree r6_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t r6_match(const Ctx& c, const std::size_t begin);
+		inline cebnf::SyntaxTree e41_parse(const Ctx& c, const std::size_t begin);
+		inline std::size_t e41_match(const Ctx& c, const std::size_t begin);
+
+		inline const auto prim0 = [] {
+			auto res = cebnf::StringIE2('\x22', '\x22');
+			res.TokenID = 10000019u;
+			return res;
+		}();
+		inline const auto prim1 = [] {
+			auto res = cebnf::Number();
+			res.TokenID = 6u;
+			return res;
+		}();
+		inline const auto prim2 = [] {
+			auto res = cebnf::Span(cebnf::CharSet(std::array<std::uint64_t, 4>{ { 4294977024ULL, 0ULL, 0ULL, 0ULL } }));
+			res.TokenID = 10000021u;
+			return res;
+		}();
+
+		inline std::size_t skip(const Ctx& c, std::size_t pos) {
+			if (!c.skip) return pos;
+			while (true) {
+				const std::size_t len = e41_match(c, pos);
+				if (len == cebnf::no_match || len == 0) return pos;
+				pos += len;
+			}
+		}
+
+		inline cebnf::SyntaxTree e0_parse(const Ctx& c, const std::size_t begin) {
+			if (c.n - begin >= 4 && std::memcmp(c.p + begin, "null", 4) == 0) return cebnf::Tree::Create(10000001u, std::string("null", 4), 4, begin);
+			return cebnf::Tree::Create();
+		}
+
+		inline std::size_t e0_match(const Ctx& c, const std::size_t begin) {
+			return (c.n - begin >= 4 && std::memcmp(c.p + begin, "null", 4) == 0) ? 4 : cebnf::no_match;
+		}
+
+		inline cebnf::SyntaxTree e1_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree children = e0_parse(c, begin);
+			if (cebnf::Tree::Failed(children)) return cebnf::Tree::Create();
+
+			cebnf::SyntaxTree res = cebnf::Tree::Create(1u, c.str->substr(begin, children.second), children.second, begin);
+			if (!cebnf::Tree::IsEpsilon(children)) res.first[0]->mergeChildren(std::move(children.first));
+			return res;
+		}
+
+		inline std::size_t e1_match(const Ctx& c, const std::size_t begin) {
+			return e0_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e2_parse(const Ctx& c, const std::size_t begin) {
+			if (c.n - begin >= 4 && std::memcmp(c.p + begin, "true", 4) == 0) return cebnf::Tree::Create(3u, std::string("true", 4), 4, begin);
+			return cebnf::Tree::Create();
+		}
+
+		inline std::size_t e2_match(const Ctx& c, const std::size_t begin) {
+			return (c.n - begin >= 4 && std::memcmp(c.p + begin, "true", 4) == 0) ? 4 : cebnf::no_match;
+		}
+
+		inline cebnf::SyntaxTree e3_parse(const Ctx& c, const std::size_t begin) {
+			if (c.n - begin >= 5 && std::memcmp(c.p + begin, "false", 5) == 0) return cebnf::Tree::Create(4u, std::string("false", 5), 5, begin);
+			return cebnf::Tree::Create();
+		}
+
+		inline std::size_t e3_match(const Ctx& c, const std::size_t begin) {
+			return (c.n - begin >= 5 && std::memcmp(c.p + begin, "false", 5) == 0) ? 5 : cebnf::no_match;
+		}
+
+		inline cebnf::SyntaxTree e4_parse(const Ctx& c, const std::size_t begin) {
+			switch (static_cast<unsigned char>(c.p[begin])) {
+			case 't':
+				return e2_parse(c, begin);
+			case 'f':
+				return e3_parse(c, begin);
+			default:
+				return cebnf::Tree::Create();
+			}
+		}
+
+		inline std::size_t e4_match(const Ctx& c, const std::size_t begin) {
+			switch (static_cast<unsigned char>(c.p[begin])) {
+			case 't':
+				return e2_match(c, begin);
+			case 'f':
+				return e3_match(c, begin);
+			default:
+				return cebnf::no_match;
+			}
+		}
+
+		inline cebnf::SyntaxTree e5_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree children = e4_parse(c, begin);
+			if (cebnf::Tree::Failed(children)) return cebnf::Tree::Create();
+
+			cebnf::SyntaxTree res = cebnf::Tree::Create(2u, c.str->substr(begin, children.second), children.second, begin);
+			if (!cebnf::Tree::IsEpsilon(children)) res.first[0]->mergeChildren(std::move(children.first));
+			return res;
+		}
+
+		inline std::size_t e5_match(const Ctx& c, const std::size_t begin) {
+			return e4_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e6_parse(const Ctx& c, const std::size_t begin) {
+			return prim0.parse_impl(*c.raw, begin);
+		}
+
+		inline std::size_t e6_match(const Ctx& c, const std::size_t begin) {
+			return prim0.match_impl(*c.raw, begin);
+		}
+
+		inline cebnf::SyntaxTree e7_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree children = e6_parse(c, begin);
+			if (cebnf::Tree::Failed(children)) return cebnf::Tree::Create();
+
+			cebnf::SyntaxTree res = cebnf::Tree::Create(5u, c.str->substr(begin, children.second), children.second, begin);
+			if (!cebnf::Tree::IsEpsilon(children)) res.first[0]->mergeChildren(std::move(children.first));
+			return res;
+		}
+
+		inline std::size_t e7_match(const Ctx& c, const std::size_t begin) {
+			return e6_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e8_parse(const Ctx& c, const std::size_t begin) {
+			return prim1.parse_impl(*c.raw, begin);
+		}
+
+		inline std::size_t e8_match(const Ctx& c, const std::size_t begin) {
+			return prim1.match_impl(*c.raw, begin);
+		}
+
+		inline cebnf::SyntaxTree e9_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree children = e8_parse(c, begin);
+			if (cebnf::Tree::Failed(children)) return cebnf::Tree::Create();
+			if (children.first.size() == 1 && !cebnf::Tree::IsEpsilon(children)) return children;
+
+			cebnf::SyntaxTree res = cebnf::Tree::Create(6u, c.str->substr(begin, children.second), children.second, begin);
+			if (!cebnf::Tree::IsEpsilon(children)) res.first[0]->mergeChildren(std::move(children.first));
+			return res;
+		}
+
+		inline std::size_t e9_match(const Ctx& c, const std::size_t begin) {
+			return e8_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e10_parse(const Ctx& c, const std::size_t begin) {
+			switch (static_cast<unsigned char>(c.p[begin])) {
+			case 'n':
+				return e1_parse(c, begin);
+			case 'f': case 't':
+				return e5_parse(c, begin);
+			case '"':
+				return e7_parse(c, begin);
+			case '+': case '-': case '.': case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+				return e9_parse(c, begin);
+			case '{':
+				return r5_parse(c, begin);
+			case '[':
+				return r6_parse(c, begin);
+			default:
+				return cebnf::Tree::Create();
+			}
+		}
+
+		inline std::size_t e10_match(const Ctx& c, const std::size_t begin) {
+			switch (static_cast<unsigned char>(c.p[begin])) {
+			case 'n':
+				return e1_match(c, begin);
+			case 'f': case 't':
+				return e5_match(c, begin);
+			case '"':
+				return e7_match(c, begin);
+			case '+': case '-': case '.': case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+				return e9_match(c, begin);
+			case '{':
+				return r5_match(c, begin);
+			case '[':
+				return r6_match(c, begin);
+			default:
+				return cebnf::no_match;
+			}
+		}
+
+		inline cebnf::SyntaxTree r0_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree children = e10_parse(c, begin);
+			if (cebnf::Tree::Failed(children)) return cebnf::Tree::Create();
+			if (children.first.size() == 1 && !cebnf::Tree::IsEpsilon(children)) return children;
+
+			cebnf::SyntaxTree res = cebnf::Tree::Create(0u, c.str->substr(begin, children.second), children.second, begin);
+			if (!cebnf::Tree::IsEpsilon(children)) res.first[0]->mergeChildren(std::move(children.first));
+			return res;
+		}
+
+		inline std::size_t r0_match(const Ctx& c, const std::size_t begin) {
+			return e10_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e11_parse(const Ctx& c, const std::size_t begin) {
+			if (c.n - begin >= 1 && std::memcmp(c.p + begin, "{", 1) == 0) return cebnf::Tree::Create(10000001u, std::string("{", 1), 1, begin);
+			return cebnf::Tree::Create();
+		}
+
+		inline std::size_t e11_match(const Ctx& c, const std::size_t begin) {
+			return (c.n - begin >= 1 && std::memcmp(c.p + begin, "{", 1) == 0) ? 1 : cebnf::no_match;
+		}
+
+		inline cebnf::SyntaxTree e12_parse(const Ctx& c, const std::size_t begin) {
+			const std::size_t len = e11_match(c, begin);
+			if (len == cebnf::no_match) return cebnf::Tree::Create();
+			return cebnf::Tree::Empty(len);
+		}
+
+		inline std::size_t e12_match(const Ctx& c, const std::size_t begin) {
+			return e11_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e13_parse(const Ctx& c, const std::size_t begin) {
+			return prim0.parse_impl(*c.raw, begin);
+		}
+
+		inline std::size_t e13_match(const Ctx& c, const std::size_t begin) {
+			return prim0.match_impl(*c.raw, begin);
+		}
+
+		inline cebnf::SyntaxTree e14_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree children = e13_parse(c, begin);
+			if (cebnf::Tree::Failed(children)) return cebnf::Tree::Create();
+
+			cebnf::SyntaxTree res = cebnf::Tree::Create(5u, c.str->substr(begin, children.second), children.second, begin);
+			if (!cebnf::Tree::IsEpsilon(children)) res.first[0]->mergeChildren(std::move(children.first));
+			return res;
+		}
+
+		inline std::size_t e14_match(const Ctx& c, const std::size_t begin) {
+			return e13_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e15_parse(const Ctx& c, const std::size_t begin) {
+			if (c.n - begin >= 1 && std::memcmp(c.p + begin, ":", 1) == 0) return cebnf::Tree::Create(10000001u, std::string(":", 1), 1, begin);
+			return cebnf::Tree::Create();
+		}
+
+		inline std::size_t e15_match(const Ctx& c, const std::size_t begin) {
+			return (c.n - begin >= 1 && std::memcmp(c.p + begin, ":", 1) == 0) ? 1 : cebnf::no_match;
+		}
+
+		inline cebnf::SyntaxTree e16_parse(const Ctx& c, const std::size_t begin) {
+			const std::size_t len = e15_match(c, begin);
+			if (len == cebnf::no_match) return cebnf::Tree::Create();
+			return cebnf::Tree::Empty(len);
+		}
+
+		inline std::size_t e16_match(const Ctx& c, const std::size_t begin) {
+			return e15_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e17_parse(const Ctx& c, const std::size_t begin) {
+			if (c.n - begin >= 1 && std::memcmp(c.p + begin, ",", 1) == 0) return cebnf::Tree::Create(10000001u, std::string(",", 1), 1, begin);
+			return cebnf::Tree::Create();
+		}
+
+		inline std::size_t e17_match(const Ctx& c, const std::size_t begin) {
+			return (c.n - begin >= 1 && std::memcmp(c.p + begin, ",", 1) == 0) ? 1 : cebnf::no_match;
+		}
+
+		inline cebnf::SyntaxTree e18_parse(const Ctx& c, const std::size_t begin) {
+			const std::size_t len = e17_match(c, begin);
+			if (len == cebnf::no_match) return cebnf::Tree::Create();
+			return cebnf::Tree::Empty(len);
+		}
+
+		inline std::size_t e18_match(const Ctx& c, const std::size_t begin) {
+			return e17_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e19_parse(const Ctx& c, const std::size_t begin) {
+			return prim0.parse_impl(*c.raw, begin);
+		}
+
+		inline std::size_t e19_match(const Ctx& c, const std::size_t begin) {
+			return prim0.match_impl(*c.raw, begin);
+		}
+
+		inline cebnf::SyntaxTree e20_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree children = e19_parse(c, begin);
+			if (cebnf::Tree::Failed(children)) return cebnf::Tree::Create();
+
+			cebnf::SyntaxTree res = cebnf::Tree::Create(5u, c.str->substr(begin, children.second), children.second, begin);
+			if (!cebnf::Tree::IsEpsilon(children)) res.first[0]->mergeChildren(std::move(children.first));
+			return res;
+		}
+
+		inline std::size_t e20_match(const Ctx& c, const std::size_t begin) {
+			return e19_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e21_parse(const Ctx& c, const std::size_t begin) {
+			if (c.n - begin >= 1 && std::memcmp(c.p + begin, ":", 1) == 0) return cebnf::Tree::Create(10000001u, std::string(":", 1), 1, begin);
+			return cebnf::Tree::Create();
+		}
+
+		inline std::size_t e21_match(const Ctx& c, const std::size_t begin) {
+			return (c.n - begin >= 1 && std::memcmp(c.p + begin, ":", 1) == 0) ? 1 : cebnf::no_match;
+		}
+
+		inline cebnf::SyntaxTree e22_parse(const Ctx& c, const std::size_t begin) {
+			const std::size_t len = e21_match(c, begin);
+			if (len == cebnf::no_match) return cebnf::Tree::Create();
+			return cebnf::Tree::Empty(len);
+		}
+
+		inline std::size_t e22_match(const Ctx& c, const std::size_t begin) {
+			return e21_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e23_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree res = e18_parse(c, begin);
+			if (cebnf::Tree::Failed(res)) return cebnf::Tree::Create();
+			{
+				const std::size_t pos = skip(c, begin + res.second);
+				cebnf::SyntaxTree x = e20_parse(c, pos);
+				if (cebnf::Tree::Failed(x)) return cebnf::Tree::Create();
+				if (x.second > 0) res.second = pos - begin;
+				cebnf::Tree::Merge(res, std::move(x));
+			}
+			{
+				const std::size_t pos = skip(c, begin + res.second);
+				cebnf::SyntaxTree x = e22_parse(c, pos);
+				if (cebnf::Tree::Failed(x)) return cebnf::Tree::Create();
+				if (x.second > 0) res.second = pos - begin;
+				cebnf::Tree::Merge(res, std::move(x));
+			}
+			{
+				const std::size_t pos = skip(c, begin + res.second);
+				cebnf::SyntaxTree x = r0_parse(c, pos);
+				if (cebnf::Tree::Failed(x)) return cebnf::Tree::Create();
+				if (x.second > 0) res.second = pos - begin;
+				cebnf::Tree::Merge(res, std::move(x));
+			}
+			return res;
+		}
+
+		inline std::size_t e23_match(const Ctx& c, const std::size_t begin) {
+			std::size_t len = e18_match(c, begin);
+			if (len == cebnf::no_match) return cebnf::no_match;
+			{
+				const std::size_t pos = skip(c, begin + len);
+				const std::size_t x = e20_match(c, pos);
+				if (x == cebnf::no_match) return cebnf::no_match;
+				if (x > 0) len = pos - begin + x;
+			}
+			{
+				const std::size_t pos = skip(c, begin + len);
+				const std::size_t x = e22_match(c, pos);
+				if (x == cebnf::no_match) return cebnf::no_match;
+				if (x > 0) len = pos - begin + x;
+			}
+			{
+				const std::size_t pos = skip(c, begin + len);
+				const std::size_t x = r0_match(c, pos);
+				if (x == cebnf::no_match) return cebnf::no_match;
+				if (x > 0) len = pos - begin + x;
+			}
+			return len;
+		}
+
+		inline cebnf::SyntaxTree e24_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree res = e23_parse(c, begin);
+			if (cebnf::Tree::Failed(res)) return cebnf::Tree::Create(cebnf::cebnf_type::epsilon, "", 0);
+
+			unsigned int count = 1;
+			while (count < 4294967295u) {
+				const std::size_t pos = skip(c, begin + res.second);
+				cebnf::SyntaxTree x = e23_parse(c, pos);
+				if (cebnf::Tree::Failed(x)) break;
+				if (x.second > 0) res.second = pos - begin;
+				cebnf::Tree::Merge(res, std::move(x));
+				count++;
+			}
+			return res;
+		}
+
+		inline std::size_t e24_match(const Ctx& c, const std::size_t begin) {
+			std::size_t len = e23_match(c, begin);
+			if (len == cebnf::no_match) return 0;
+
+			unsigned int count = 1;
+			while (count < 4294967295u) {
+				const std::size_t pos = skip(c, begin + len);
+				const std::size_t x = e23_match(c, pos);
+				if (x == cebnf::no_match) break;
+				if (x > 0) len = pos - begin + x;
+				count++;
+			}
+			return len;
+		}
+
+		inline cebnf::SyntaxTree e25_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree res = e14_parse(c, begin);
+			if (cebnf::Tree::Failed(res)) return cebnf::Tree::Create();
+			{
+				const std::size_t pos = skip(c, begin + res.second);
+				cebnf::SyntaxTree x = e16_parse(c, pos);
+				if (cebnf::Tree::Failed(x)) return cebnf::Tree::Create();
+				if (x.second > 0) res.second = pos - begin;
+				cebnf::Tree::Merge(res, std::move(x));
+			}
+			{
+				const std::size_t pos = skip(c, begin + res.second);
+				cebnf::SyntaxTree x = r0_parse(c, pos);
+				if (cebnf::Tree::Failed(x)) return cebnf::Tree::Create();
+				if (x.second > 0) res.second = pos - begin;
+				cebnf::Tree::Merge(res, std::move(x));
+			}
+			{
+				const std::size_t pos = skip(c, begin + res.second);
+				cebnf::SyntaxTree x = e24_parse(c, pos);
+				if (cebnf::Tree::Failed(x)) return cebnf::Tree::Create();
+				if (x.second > 0) res.second = pos - begin;
+				cebnf::Tree::Merge(res, std::move(x));
+			}
+			return res;
+		}
+
+		inline std::size_t e25_match(const Ctx& c, const std::size_t begin) {
+			std::size_t len = e14_match(c, begin);
+			if (len == cebnf::no_match) return cebnf::no_match;
+			{
+				const std::size_t pos = skip(c, begin + len);
+				const std::size_t x = e16_match(c, pos);
+				if (x == cebnf::no_match) return cebnf::no_match;
+				if (x > 0) len = pos - begin + x;
+			}
+			{
+				const std::size_t pos = skip(c, begin + len);
+				const std::size_t x = r0_match(c, pos);
+				if (x == cebnf::no_match) return cebnf::no_match;
+				if (x > 0) len = pos - begin + x;
+			}
+			{
+				const std::size_t pos = skip(c, begin + len);
+				const std::size_t x = e24_match(c, pos);
+				if (x == cebnf::no_match) return cebnf::no_match;
+				if (x > 0) len = pos - begin + x;
+			}
+			return len;
+		}
+
+		inline cebnf::SyntaxTree e26_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree res = e25_parse(c, begin);
+			if (cebnf::Tree::Failed(res)) return cebnf::Tree::Create(cebnf::cebnf_type::epsilon, "", 0);
+			return res;
+		}
+
+		inline std::size_t e26_match(const Ctx& c, const std::size_t begin) {
+			const std::size_t len = e25_match(c, begin);
+			return len == cebnf::no_match ? 0 : len;
+		}
+
+		inline cebnf::SyntaxTree e27_parse(const Ctx& c, const std::size_t begin) {
+			if (c.n - begin >= 1 && std::memcmp(c.p + begin, "}", 1) == 0) return cebnf::Tree::Create(10000001u, std::string("}", 1), 1, begin);
+			return cebnf::Tree::Create();
+		}
+
+		inline std::size_t e27_match(const Ctx& c, const std::size_t begin) {
+			return (c.n - begin >= 1 && std::memcmp(c.p + begin, "}", 1) == 0) ? 1 : cebnf::no_match;
+		}
+
+		inline cebnf::SyntaxTree e28_parse(const Ctx& c, const std::size_t begin) {
+			const std::size_t len = e27_match(c, begin);
+			if (len == cebnf::no_match) return cebnf::Tree::Create();
+			return cebnf::Tree::Empty(len);
+		}
+
+		inline std::size_t e28_match(const Ctx& c, const std::size_t begin) {
+			return e27_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e29_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree res = e12_parse(c, begin);
+			if (cebnf::Tree::Failed(res)) return cebnf::Tree::Create();
+			{
+				const std::size_t pos = skip(c, begin + res.second);
+				cebnf::SyntaxTree x = e26_parse(c, pos);
+				if (cebnf::Tree::Failed(x)) return cebnf::Tree::Create();
+				if (x.second > 0) res.second = pos - begin;
+				cebnf::Tree::Merge(res, std::move(x));
+			}
+			{
+				const std::size_t pos = skip(c, begin + res.second);
+				cebnf::SyntaxTree x = e28_parse(c, pos);
+				if (cebnf::Tree::Failed(x)) return cebnf::Tree::Create();
+				if (x.second > 0) res.second = pos - begin;
+				cebnf::Tree::Merge(res, std::move(x));
+			}
+			return res;
+		}
+
+		inline std::size_t e29_match(const Ctx& c, const std::size_t begin) {
+			std::size_t len = e12_match(c, begin);
+			if (len == cebnf::no_match) return cebnf::no_match;
+			{
+				const std::size_t pos = skip(c, begin + len);
+				const std::size_t x = e26_match(c, pos);
+				if (x == cebnf::no_match) return cebnf::no_match;
+				if (x > 0) len = pos - begin + x;
+			}
+			{
+				const std::size_t pos = skip(c, begin + len);
+				const std::size_t x = e28_match(c, pos);
+				if (x == cebnf::no_match) return cebnf::no_match;
+				if (x > 0) len = pos - begin + x;
+			}
+			return len;
+		}
+
+		inline cebnf::SyntaxTree r5_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree children = e29_parse(c, begin);
+			if (cebnf::Tree::Failed(children)) return cebnf::Tree::Create();
+
+			cebnf::SyntaxTree res = cebnf::Tree::Create(7u, c.str->substr(begin, children.second), children.second, begin);
+			if (!cebnf::Tree::IsEpsilon(children)) res.first[0]->mergeChildren(std::move(children.first));
+			return res;
+		}
+
+		inline std::size_t r5_match(const Ctx& c, const std::size_t begin) {
+			return e29_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e30_parse(const Ctx& c, const std::size_t begin) {
+			if (c.n - begin >= 1 && std::memcmp(c.p + begin, "[", 1) == 0) return cebnf::Tree::Create(10000001u, std::string("[", 1), 1, begin);
+			return cebnf::Tree::Create();
+		}
+
+		inline std::size_t e30_match(const Ctx& c, const std::size_t begin) {
+			return (c.n - begin >= 1 && std::memcmp(c.p + begin, "[", 1) == 0) ? 1 : cebnf::no_match;
+		}
+
+		inline cebnf::SyntaxTree e31_parse(const Ctx& c, const std::size_t begin) {
+			const std::size_t len = e30_match(c, begin);
+			if (len == cebnf::no_match) return cebnf::Tree::Create();
+			return cebnf::Tree::Empty(len);
+		}
+
+		inline std::size_t e31_match(const Ctx& c, const std::size_t begin) {
+			return e30_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e32_parse(const Ctx& c, const std::size_t begin) {
+			if (c.n - begin >= 1 && std::memcmp(c.p + begin, ",", 1) == 0) return cebnf::Tree::Create(10000001u, std::string(",", 1), 1, begin);
+			return cebnf::Tree::Create();
+		}
+
+		inline std::size_t e32_match(const Ctx& c, const std::size_t begin) {
+			return (c.n - begin >= 1 && std::memcmp(c.p + begin, ",", 1) == 0) ? 1 : cebnf::no_match;
+		}
+
+		inline cebnf::SyntaxTree e33_parse(const Ctx& c, const std::size_t begin) {
+			const std::size_t len = e32_match(c, begin);
+			if (len == cebnf::no_match) return cebnf::Tree::Create();
+			return cebnf::Tree::Empty(len);
+		}
+
+		inline std::size_t e33_match(const Ctx& c, const std::size_t begin) {
+			return e32_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e34_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree res = e33_parse(c, begin);
+			if (cebnf::Tree::Failed(res)) return cebnf::Tree::Create();
+			{
+				const std::size_t pos = skip(c, begin + res.second);
+				cebnf::SyntaxTree x = r0_parse(c, pos);
+				if (cebnf::Tree::Failed(x)) return cebnf::Tree::Create();
+				if (x.second > 0) res.second = pos - begin;
+				cebnf::Tree::Merge(res, std::move(x));
+			}
+			return res;
+		}
+
+		inline std::size_t e34_match(const Ctx& c, const std::size_t begin) {
+			std::size_t len = e33_match(c, begin);
+			if (len == cebnf::no_match) return cebnf::no_match;
+			{
+				const std::size_t pos = skip(c, begin + len);
+				const std::size_t x = r0_match(c, pos);
+				if (x == cebnf::no_match) return cebnf::no_match;
+				if (x > 0) len = pos - begin + x;
+			}
+			return len;
+		}
+
+		inline cebnf::SyntaxTree e35_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree res = e34_parse(c, begin);
+			if (cebnf::Tree::Failed(res)) return cebnf::Tree::Create(cebnf::cebnf_type::epsilon, "", 0);
+
+			unsigned int count = 1;
+			while (count < 4294967295u) {
+				const std::size_t pos = skip(c, begin + res.second);
+				cebnf::SyntaxTree x = e34_parse(c, pos);
+				if (cebnf::Tree::Failed(x)) break;
+				if (x.second > 0) res.second = pos - begin;
+				cebnf::Tree::Merge(res, std::move(x));
+				count++;
+			}
+			return res;
+		}
+
+		inline std::size_t e35_match(const Ctx& c, const std::size_t begin) {
+			std::size_t len = e34_match(c, begin);
+			if (len == cebnf::no_match) return 0;
+
+			unsigned int count = 1;
+			while (count < 4294967295u) {
+				const std::size_t pos = skip(c, begin + len);
+				const std::size_t x = e34_match(c, pos);
+				if (x == cebnf::no_match) break;
+				if (x > 0) len = pos - begin + x;
+				count++;
+			}
+			return len;
+		}
+
+		inline cebnf::SyntaxTree e36_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree res = r0_parse(c, begin);
+			if (cebnf::Tree::Failed(res)) return cebnf::Tree::Create();
+			{
+				const std::size_t pos = skip(c, begin + res.second);
+				cebnf::SyntaxTree x = e35_parse(c, pos);
+				if (cebnf::Tree::Failed(x)) return cebnf::Tree::Create();
+				if (x.second > 0) res.second = pos - begin;
+				cebnf::Tree::Merge(res, std::move(x));
+			}
+			return res;
+		}
+
+		inline std::size_t e36_match(const Ctx& c, const std::size_t begin) {
+			std::size_t len = r0_match(c, begin);
+			if (len == cebnf::no_match) return cebnf::no_match;
+			{
+				const std::size_t pos = skip(c, begin + len);
+				const std::size_t x = e35_match(c, pos);
+				if (x == cebnf::no_match) return cebnf::no_match;
+				if (x > 0) len = pos - begin + x;
+			}
+			return len;
+		}
+
+		inline cebnf::SyntaxTree e37_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree res = e36_parse(c, begin);
+			if (cebnf::Tree::Failed(res)) return cebnf::Tree::Create(cebnf::cebnf_type::epsilon, "", 0);
+			return res;
+		}
+
+		inline std::size_t e37_match(const Ctx& c, const std::size_t begin) {
+			const std::size_t len = e36_match(c, begin);
+			return len == cebnf::no_match ? 0 : len;
+		}
+
+		inline cebnf::SyntaxTree e38_parse(const Ctx& c, const std::size_t begin) {
+			if (c.n - begin >= 1 && std::memcmp(c.p + begin, "]", 1) == 0) return cebnf::Tree::Create(10000001u, std::string("]", 1), 1, begin);
+			return cebnf::Tree::Create();
+		}
+
+		inline std::size_t e38_match(const Ctx& c, const std::size_t begin) {
+			return (c.n - begin >= 1 && std::memcmp(c.p + begin, "]", 1) == 0) ? 1 : cebnf::no_match;
+		}
+
+		inline cebnf::SyntaxTree e39_parse(const Ctx& c, const std::size_t begin) {
+			const std::size_t len = e38_match(c, begin);
+			if (len == cebnf::no_match) return cebnf::Tree::Create();
+			return cebnf::Tree::Empty(len);
+		}
+
+		inline std::size_t e39_match(const Ctx& c, const std::size_t begin) {
+			return e38_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e40_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree res = e31_parse(c, begin);
+			if (cebnf::Tree::Failed(res)) return cebnf::Tree::Create();
+			{
+				const std::size_t pos = skip(c, begin + res.second);
+				cebnf::SyntaxTree x = e37_parse(c, pos);
+				if (cebnf::Tree::Failed(x)) return cebnf::Tree::Create();
+				if (x.second > 0) res.second = pos - begin;
+				cebnf::Tree::Merge(res, std::move(x));
+			}
+			{
+				const std::size_t pos = skip(c, begin + res.second);
+				cebnf::SyntaxTree x = e39_parse(c, pos);
+				if (cebnf::Tree::Failed(x)) return cebnf::Tree::Create();
+				if (x.second > 0) res.second = pos - begin;
+				cebnf::Tree::Merge(res, std::move(x));
+			}
+			return res;
+		}
+
+		inline std::size_t e40_match(const Ctx& c, const std::size_t begin) {
+			std::size_t len = e31_match(c, begin);
+			if (len == cebnf::no_match) return cebnf::no_match;
+			{
+				const std::size_t pos = skip(c, begin + len);
+				const std::size_t x = e37_match(c, pos);
+				if (x == cebnf::no_match) return cebnf::no_match;
+				if (x > 0) len = pos - begin + x;
+			}
+			{
+				const std::size_t pos = skip(c, begin + len);
+				const std::size_t x = e39_match(c, pos);
+				if (x == cebnf::no_match) return cebnf::no_match;
+				if (x > 0) len = pos - begin + x;
+			}
+			return len;
+		}
+
+		inline cebnf::SyntaxTree r6_parse(const Ctx& c, const std::size_t begin) {
+			cebnf::SyntaxTree children = e40_parse(c, begin);
+			if (cebnf::Tree::Failed(children)) return cebnf::Tree::Create();
+
+			cebnf::SyntaxTree res = cebnf::Tree::Create(8u, c.str->substr(begin, children.second), children.second, begin);
+			if (!cebnf::Tree::IsEpsilon(children)) res.first[0]->mergeChildren(std::move(children.first));
+			return res;
+		}
+
+		inline std::size_t r6_match(const Ctx& c, const std::size_t begin) {
+			return e40_match(c, begin);
+		}
+
+		inline cebnf::SyntaxTree e41_parse(const Ctx& c, const std::size_t begin) {
+			return prim2.parse_impl(*c.raw, begin);
+		}
+
+		inline std::size_t e41_match(const Ctx& c, const std::size_t begin) {
+			return prim2.match_impl(*c.raw, begin);
+		}
+
+	}
+
+	/*same as CEBNF::parse of the start rule*/
+	inline std::unique_ptr<cebnf::SyntaxNode> parse(const std::string& s) {
+		const cebnf::Input raw(s);
+		const detail::Ctx c{ &s, s.data(), s.size(), &raw, true };
+		const std::size_t begin = detail::skip(c, 0);
+
+		cebnf::SyntaxTree tree = detail::r0_parse(c, begin);
+		if (cebnf::Tree::Failed(tree) || detail::skip(c, begin + tree.second) != s.length()) {
+			return nullptr;
+		}
+		return std::move(tree.first[0]);
+	}
+
+	/*same as CEBNF::match of the start rule*/
+	inline bool match(const std::string& s) {
+		const cebnf::Input raw(s);
+		const detail::Ctx c{ &s, s.data(), s.size(), &raw, true };
+		const std::size_t begin = detail::skip(c, 0);
+
+		const std::size_t len = detail::r0_match(c, begin);
+		return len != cebnf::no_match && detail::skip(c, begin + len) == s.length();
+	}
+
+}
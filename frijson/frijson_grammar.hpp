@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../cebnf/cebnf.hpp"
+#include "../cebnf/cebnf_helper.hpp"
+
+
+/*json grammar (cebnf only: shared by Parser and the parser generator frijson_gen.cpp)*/
+namespace frijson {
+
+	/*token ids of the json syntax tree*/
+	struct JsonToken {
+		enum JsonType {
+			JSON_BASE,
+			JSON_NULL,
+			JSON_BOOL,
+			JSON_BOOL_TRUE,
+			JSON_BOOL_FALSE,
+			JSON_STRING,
+			JSON_NUMERIC,
+			JSON_OBJECT,
+			JSON_ARRAY,
+			JSON_END,
+		};
+	};
+
+	/*json grammar (immutable after construction)*/
+	struct JsonGrammar : JsonToken {
+		cebnf::CEBNF<JSON_BASE		> _jbase;
+		cebnf::CEBNF<JSON_NULL		> _jnull;
+		cebnf::CEBNF<JSON_BOOL		> _jbool;
+		cebnf::CEBNF<JSON_STRING	> _jstring;
+		cebnf::CEBNF<JSON_NUMERIC	> _jnumeric;
+		cebnf::CEBNF<JSON_OBJECT	> _jobject;
+		cebnf::CEBNF<JSON_ARRAY		> _jarray;
+
+		JsonGrammar() {
+			setCEBNF();
+		}
+
+		void setCEBNF() {
+			using namespace cebnf;
+			CEBNF_OperatorTools t;
+
+			_jnull      = Term("null");
+			_jbool      = Term("true", JSON_BOOL_TRUE) | Term("false", JSON_BOOL_FALSE);
+			_jstring    = StringIE2('"', '"');
+			_jnumeric   = Number(JSON_NUMERIC);
+
+			_jobject    = t.drop(Term("{")) - t[_jstring - t.drop(Term(":")) - _jbase - t({ t.drop(Term(",")) - _jstring - t.drop(Term(":")) - _jbase })] - t.drop(Term("}"));
+			_jarray     = t.drop(Term("[")) - t[_jbase - t({ t.drop(Term(",")) - _jbase })] - t.drop(Term("]"));
+
+			_jbase = _jnull | _jbool | _jstring | _jnumeric | _jobject | _jarray;
+
+			/*no pass-through nodes: a value is its JSON_* node, a number is one JSON_NUMERIC token (Number value)*/
+			_jbase.setShape(shape_collapse);
+			_jnumeric.setShape(shape_collapse);
+
+			/*spaces, tabs, and newlines without them in strings("...")*/
+			_jbase.setSkipper(Span(CharSet(" \t\r\n")));
+		}
+
+		std::size_t memorySize() const {
+			return _jbase.memorySize() + _jnull.memorySize() + _jbool.memorySize() + _jstring.memorySize()
+				+ _jnumeric.memorySize() + _jobject.memorySize() + _jarray.memorySize();
+		}
+	};
+
+}
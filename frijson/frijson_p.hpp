@@ -4,17 +4,29 @@
 #include "../convert/converter.hpp"
 
 #include "frijson.hpp"
+#include "frijson_grammar.hpp"
+#if defined(FRIJSON_GENERATED_PARSER)
+#include "frijson_generated.hpp"
+#endif
 
 #include "../cebnf/cebnf.hpp"
 #include "../cebnf/cebnf_helper.hpp"
 
 
 namespace frijson {
-	class Parser {
+	class Parser : protected JsonToken {
 		friend class Json;
 	public:
-		Parser() {
-			setCEBNF();
+		/*O(1): the grammar is built once and shared by every Parser*/
+		Parser() : _grammar(cebnf::SharedGrammar<JsonGrammar>::get()) {}
+
+		/*own grammar (replaces the removed virtual setCEBNF): a subclass of JsonGrammar that changes the rules in its constructor.
+		the token ids and tree shapes must be those of JsonGrammar (parseImpl_*)*/
+		explicit Parser(std::shared_ptr<const JsonGrammar> grammar) : _grammar(std::move(grammar)) {}
+
+		/*bytes of the shared grammar expression objects*/
+		static std::size_t grammarMemorySize() {
+			return cebnf::SharedGrammar<JsonGrammar>::get()->memorySize();
 		}
 
 		Json parse(const String& str) {
@@ -23,10 +35,10 @@ namespace frijson {
 
 			/*UTF-8 BOM*/
 			if ((unsigned char)str[0] == 0xEF && (unsigned char)str[1] == 0xBB && (unsigned char)str[2] == 0xBF) {
-				syntax_tree = _jbase.parse(wash(str.substr(3)));
+				syntax_tree = parseSyntaxTree(wash(str.substr(3)));
 			}
 			else {
-				syntax_tree = _jbase.parse(wash(str));
+				syntax_tree = parseSyntaxTree(wash(str));
 			}
 
 			/*syntax error check*/
@@ -52,57 +64,39 @@ namespace frijson {
 		}
 
 	protected:
-		enum JsonType {
-			JSON_BASE,
-			JSON_NULL,
-			JSON_BOOL,
-			JSON_BOOL_TRUE,
-			JSON_BOOL_FALSE,
-			JSON_STRING,
-			JSON_NUMERIC,
-			JSON_OBJECT,
-			JSON_ARRAY,
-			JSON_END,
-		};
-
-		cebnf::CEBNF<JSON_BASE		> _jbase;
-		cebnf::CEBNF<JSON_NULL		> _jnull;
-		cebnf::CEBNF<JSON_BOOL		> _jbool;
-		cebnf::CEBNF<JSON_STRING	> _jstring;
-		cebnf::CEBNF<JSON_NUMERIC	> _jnumeric;
-		cebnf::CEBNF<JSON_OBJECT	> _jobject;
-		cebnf::CEBNF<JSON_ARRAY		> _jarray;
-
-		virtual void setCEBNF() {
-			using namespace cebnf;
-			CEBNF_OperatorTools t;
-
-			_jnull      = Term("null");
-			_jbool      = Term("true", JSON_BOOL_TRUE) | Term("false", JSON_BOOL_FALSE);
-			_jstring    = StringIE2('"', '"');
-			_jnumeric   = (Integer() | RealNumber()) - t[(Term("E") | Term("e")) - Integer()];
-
-			_jobject    = Term("{") - t[_jstring - Term(":") - _jbase - t({ Term(",") - _jstring - Term(":") - _jbase })] - Term("}");
-			_jarray     = Term("[") - t[_jbase - t({ Term(",") - _jbase })] - Term("]");
-
-			_jbase = _jnull | _jbool | _jstring | _jnumeric | _jobject | _jarray;
+		std::shared_ptr<const JsonGrammar> _grammar;
+
+		/*FRIJSON_GENERATED_PARSER: the parser generated from JsonGrammar (frijson_generated.hpp, same syntax tree), not for an own grammar*/
+		std::unique_ptr<cebnf::SyntaxNode> parseSyntaxTree(const std::string& str) const {
+#if defined(FRIJSON_GENERATED_PARSER)
+			if (_grammar == cebnf::SharedGrammar<JsonGrammar>::get()) {
+				return frijson_generated::parse(str);
+			}
+#endif
+			return _grammar->_jbase.parse(str);
 		}
 
 
+		/*pre-process the input before parsing (hook for subclasses). whitespace is skipped by the grammar (skipper), nothing to do here*/
+		virtual String wash(const String& str) {
+			return str;
+		}
+
+		/*value node (JSON_BASE collapses to the JSON_* node of the value)*/
 		virtual Json parseImpl_Base(std::unique_ptr<cebnf::SyntaxNode>& node) {
-			switch (node->children[0]->getTokenID()) {
+			switch (node->getTokenID()) {
 			case JSON_NULL:
-				return std::move(parseImpl_Null(node->children[0]));
+				return std::move(parseImpl_Null(node));
 			case JSON_BOOL:
-				return std::move(parseImpl_Bool(node->children[0]));
+				return std::move(parseImpl_Bool(node));
 			case JSON_STRING:
-				return std::move(parseImpl_String(node->children[0]));
+				return std::move(parseImpl_String(node));
 			case JSON_NUMERIC:
-				return std::move(parseImpl_Numeric(node->children[0]));
+				return std::move(parseImpl_Numeric(node));
 			case JSON_OBJECT:
-				return std::move(parseImpl_Object(node->children[0]));
+				return std::move(parseImpl_Object(node));
 			case JSON_ARRAY:
-				return std::move(parseImpl_Array(node->children[0]));
+				return std::move(parseImpl_Array(node));
 			default:
 				return std::move(Json::createNull());
 			}
@@ -139,77 +133,39 @@ namespace frijson {
 			return std::move(Json::createString(getString_ofSyntaxTreeJsonString(node)));
 		}
 
+		/*JsonNumeric: one Number token (value parsed while matching)*/
 		virtual Json parseImpl_Numeric(std::unique_ptr<cebnf::SyntaxNode>& node) {
-			return std::move(Json::createNumeric(node->getString()));
+			if (node->isInteger()) {
+				return std::move(Json::createNumeric(node->getString(), static_cast<long long>(node->getInteger())));
+			}
+			else {
+				return std::move(Json::createNumeric(node->getString(), node->getReal()));
+			}
 		}
 
 		virtual Json parseImpl_Object(std::unique_ptr<cebnf::SyntaxNode>& node) {
 			const size_t children_size = node->children.size();
 
 			Json obj = Json::createObject();
-			/*first: { */
-			size_t itr = 1;
-			/*obj children size:: 2, 5, 9, pre+4...*/
-			while (itr + 1 < children_size) {
-				obj._dat->getObj()[getString_ofSyntaxTreeJsonString(node->children[itr])] = parseImpl_Base(node->children[itr + 2]);
-				/*add itr:: {String, <:>, JsonData} and comma<,>*/
-				itr += 4;
+			/*obj children:: {String, JsonData} pairs ( { : , } are dropped)*/
+			for (size_t itr = 0; itr + 1 < children_size; itr += 2) {
+				obj._dat->getObj()[getString_ofSyntaxTreeJsonString(node->children[itr])] = parseImpl_Base(node->children[itr + 1]);
 			}
 
 			return std::move(obj);
 		}
 
 		virtual Json parseImpl_Array(std::unique_ptr<cebnf::SyntaxNode>& node) {
-			const size_t children_size = node->children.size();
-			const size_t arr_size = (children_size - 1) / 2;
+			const size_t arr_size = node->children.size();
 
 			Json arr = Json::createArray(arr_size);
-			/*first: [ */
-			size_t itr = 1;
-			size_t arr_itr = 0;
-			/*arr children size:: 2, 3, 5, pre+2...*/
-			while (itr + 1 < children_size) {
-				arr._dat->getArr().at(arr_itr) = parseImpl_Base(node->children[itr]);
-				/*add {JsonData} and comma<,>*/
-				itr += 2;
-				arr_itr++;
+			/*arr children:: {JsonData} ( [ , ] are dropped)*/
+			for (size_t itr = 0; itr < arr_size; ++itr) {
+				arr._dat->getArr().at(itr) = parseImpl_Base(node->children[itr]);
 			}
 
 			return std::move(arr);
 		}
-
-		/*remove spaces, tabs, and newlines without them in strings("...")*/
-		virtual String wash(const String& str) {
-			String dst;
-			dst.reserve(str.length());
-			size_t itr = 0;
-			bool string_flag = false;
-			while (str[itr] != '\0') {
-				if (str[itr] == '"') {
-					string_flag = !string_flag;
-					dst += '"';
-				}
-				else if (str[itr] == '\\') {
-					dst += '\\';
-					itr++;
-					dst += str[itr];
-				}
-				else if (str[itr] == ' ' || str[itr] == '\t' || str[itr] == '\r' || str[itr] == '\n') {
-					if (string_flag) {
-						dst += str[itr];
-					}
-				}
-				else {
-					dst += str[itr];
-				}
-
-				itr++;
-			}
-
-			return std::move(dst);
-		}
-
-
 	};
 
 }
@@ -0,0 +1,17 @@
+/*finds the JSON objects embedded in text files (logs, ...) on every core (cebnf_parallel.hpp)
+usage: frijson_scan [-j threads] [-s chunk bytes] [-c] [-w] [files...] (no files: paths from stdin)
+output: path:begin:length per object, or with -c the nodes per token id (frijson::JsonToken)*/
+#include "frijson_grammar.hpp"
+#include "../cebnf/cebnf_parallel.hpp"
+
+/*objects are searched on their own: the skipper of JSON_BASE is set on JSON_OBJECT*/
+struct ObjectGrammar : frijson::JsonGrammar {
+	ObjectGrammar() {
+		_jobject.setSkipper(cebnf::Span(cebnf::CharSet(" \t\r\n")));
+	}
+};
+
+int main(int argc, char* argv[]) {
+	const ObjectGrammar grammar;
+	return cebnf::scanMain(argc, argv, grammar._jobject);
+}